@@ -0,0 +1,376 @@
+// -*- C++ -*-
+//===----------------------------------------------------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is dual licensed under the MIT and the University of Illinois Open
+// Source Licenses. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _LIBCPP__DENSE_HASH_TABLE
+#define _LIBCPP__DENSE_HASH_TABLE
+
+#include <__config>
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <__undef_min_max>
+
+#include <__debug>
+
+#if !defined(_LIBCPP_HAS_NO_PRAGMA_SYSTEM_HEADER)
+#pragma GCC system_header
+#endif
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+
+#ifndef _LIBCPP_CXX03_LANG
+
+        // START ADDED CODE
+        // Chained hash table over dense storage. The elements sit back to back
+        // in one vector in insertion order (until an erase), and the chains
+        // are 32-bit indices into it: __buckets_[b] is the first element of
+        // bucket b and __next_[i] the one after element i. Erasing moves the
+        // last element into the hole, so the vector never has gaps and
+        // iteration is a linear scan. No hash is cached; __rehash and erase
+        // recompute the hashes they need. At most 2^32 - 2 elements.
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        class __dense_hash_table
+        {
+        public:
+            typedef _Tp    value_type;
+            typedef _Hash  hasher;
+            typedef _Equal key_equal;
+            typedef _Alloc allocator_type;
+
+        private:
+            typedef allocator_traits<allocator_type> __alloc_traits;
+            typedef typename __rebind_alloc_helper<__alloc_traits, uint32_t>::type __index_allocator;
+            typedef vector<value_type, allocator_type>  __value_list;
+            typedef vector<uint32_t, __index_allocator> __index_list;
+
+            enum : uint32_t {__npos = 0xFFFFFFFFu};
+
+        public:
+            typedef value_type&                              reference;
+            typedef const value_type&                        const_reference;
+            typedef typename __alloc_traits::pointer         pointer;
+            typedef typename __alloc_traits::const_pointer   const_pointer;
+            typedef typename __alloc_traits::size_type       size_type;
+            typedef typename __alloc_traits::difference_type difference_type;
+
+            typedef typename __value_list::const_iterator const_iterator;
+            typedef const_iterator                        iterator;
+
+        private:
+            // --- Member data begin ---
+            __value_list                          __values_;
+            __index_list                          __next_;
+            // Empty, or a power of two in size.
+            __index_list                          __buckets_;
+            __compressed_pair<unsigned, hasher>   __p1_;
+            __compressed_pair<float, key_equal>   __p2_;
+            // --- Member data end ---
+
+            // log2 of the bucket count, at least 1; only meaningful while there
+            // are buckets.
+            _LIBCPP_INLINE_VISIBILITY
+            unsigned& __shift() _NOEXCEPT {return __p1_.first();}
+            _LIBCPP_INLINE_VISIBILITY
+            unsigned __shift() const _NOEXCEPT {return __p1_.first();}
+
+        public:
+            _LIBCPP_INLINE_VISIBILITY
+            size_type size() const _NOEXCEPT {return __values_.size();}
+            _LIBCPP_INLINE_VISIBILITY
+            hasher& hash_function() _NOEXCEPT {return __p1_.second();}
+            _LIBCPP_INLINE_VISIBILITY
+            const hasher& hash_function() const _NOEXCEPT {return __p1_.second();}
+            _LIBCPP_INLINE_VISIBILITY
+            key_equal& key_eq() _NOEXCEPT {return __p2_.second();}
+            _LIBCPP_INLINE_VISIBILITY
+            const key_equal& key_eq() const _NOEXCEPT {return __p2_.second();}
+            _LIBCPP_INLINE_VISIBILITY
+            allocator_type __alloc() const _NOEXCEPT {return __values_.get_allocator();}
+
+            _LIBCPP_INLINE_VISIBILITY
+            __dense_hash_table()
+                _NOEXCEPT_(
+                    is_nothrow_default_constructible<allocator_type>::value &&
+                    is_nothrow_default_constructible<hasher>::value &&
+                    is_nothrow_default_constructible<key_equal>::value)
+                    : __p1_(0), __p2_(1.0f) {}
+            _LIBCPP_INLINE_VISIBILITY
+            __dense_hash_table(const hasher& __hf, const key_equal& __eql)
+                    : __p1_(0, __hf), __p2_(1.0f, __eql) {}
+            _LIBCPP_INLINE_VISIBILITY
+            __dense_hash_table(const hasher& __hf, const key_equal& __eql,
+                               const allocator_type& __a)
+                    : __values_(__a),
+                      __next_(__index_allocator(__a)),
+                      __buckets_(__index_allocator(__a)),
+                      __p1_(0, __hf),
+                      __p2_(1.0f, __eql) {}
+            _LIBCPP_INLINE_VISIBILITY
+            explicit __dense_hash_table(const allocator_type& __a)
+                    : __values_(__a),
+                      __next_(__index_allocator(__a)),
+                      __buckets_(__index_allocator(__a)),
+                      __p1_(0),
+                      __p2_(1.0f) {}
+            // The implicit copy and move operations are correct member-wise:
+            // the indices stay valid because the element order is copied too.
+            _LIBCPP_INLINE_VISIBILITY
+            __dense_hash_table(const __dense_hash_table& __u, const allocator_type& __a)
+                    : __values_(__u.__values_, __a),
+                      __next_(__u.__next_, __index_allocator(__a)),
+                      __buckets_(__u.__buckets_, __index_allocator(__a)),
+                      __p1_(__u.__p1_),
+                      __p2_(__u.__p2_) {}
+            _LIBCPP_INLINE_VISIBILITY
+            __dense_hash_table(__dense_hash_table&& __u, const allocator_type& __a)
+                    : __values_(_VSTD::move(__u.__values_), __a),
+                      __next_(_VSTD::move(__u.__next_), __index_allocator(__a)),
+                      __buckets_(_VSTD::move(__u.__buckets_), __index_allocator(__a)),
+                      __p1_(_VSTD::move(__u.__p1_)),
+                      __p2_(_VSTD::move(__u.__p2_))
+            {
+                __u.clear();
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            size_type max_size() const _NOEXCEPT
+            {
+                return _VSTD::min<size_type>(__values_.max_size(), __npos - 1);
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            const_iterator begin() const _NOEXCEPT {return __values_.begin();}
+            _LIBCPP_INLINE_VISIBILITY
+            const_iterator end() const _NOEXCEPT {return __values_.end();}
+
+            template <class _Key>
+            _LIBCPP_INLINE_VISIBILITY
+            const_iterator find(const _Key& __k) const
+            {
+                uint32_t __i = __find_index(__k, hash_function()(__k));
+                return __i == __npos ? end() : begin() + __i;
+            }
+            template <class _Key>
+            _LIBCPP_INLINE_VISIBILITY
+            size_type __count_unique(const _Key& __k) const
+            {return __find_index(__k, hash_function()(__k)) != __npos;}
+
+            template <class _Vp>
+            pair<iterator, bool> __insert_unique(_Vp&& __v);
+            template <class... _Args>
+            _LIBCPP_INLINE_VISIBILITY
+            pair<iterator, bool> __emplace_unique(_Args&&... __args)
+            {return __insert_unique(value_type(_VSTD::forward<_Args>(__args)...));}
+
+            iterator erase(const_iterator __p);
+            iterator erase(const_iterator __first, const_iterator __last);
+            template <class _Key>
+            size_type __erase_unique(const _Key& __k);
+            _LIBCPP_INLINE_VISIBILITY
+            void clear() _NOEXCEPT
+            {
+                __values_.clear();
+                __next_.clear();
+                _VSTD::fill(__buckets_.begin(), __buckets_.end(), __npos);
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            void swap(__dense_hash_table& __u)
+                _NOEXCEPT_DEBUG_(__is_nothrow_swappable<hasher>::value &&
+                                 __is_nothrow_swappable<key_equal>::value)
+            {
+                __values_.swap(__u.__values_);
+                __next_.swap(__u.__next_);
+                __buckets_.swap(__u.__buckets_);
+                __p1_.swap(__u.__p1_);
+                __p2_.swap(__u.__p2_);
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            size_type bucket_count() const _NOEXCEPT {return __buckets_.size();}
+            _LIBCPP_INLINE_VISIBILITY
+            float load_factor() const _NOEXCEPT
+            {
+                size_type __bc = bucket_count();
+                return __bc != 0 ? (float)size() / __bc : 0.f;
+            }
+            _LIBCPP_INLINE_VISIBILITY
+            float max_load_factor() const _NOEXCEPT {return __p2_.first();}
+            _LIBCPP_INLINE_VISIBILITY
+            void max_load_factor(float __mlf) _NOEXCEPT
+            {
+                _LIBCPP_ASSERT(__mlf > 0,
+                    "unordered container::max_load_factor(lf) called with lf <= 0");
+                __p2_.first() = _VSTD::max(__mlf, load_factor());
+            }
+            void rehash(size_type __n);
+            _LIBCPP_INLINE_VISIBILITY
+            void reserve(size_type __n)
+            {
+                __values_.reserve(__n);
+                __next_.reserve(__n);
+                rehash(static_cast<size_type>(ceil(__n / max_load_factor())));
+            }
+
+        private:
+            // Multiplicative hashing: the top __shift() bits of the product pick
+            // the bucket, so identity hashes of small integers still spread.
+            _LIBCPP_INLINE_VISIBILITY
+            size_t __bucket(size_t __h) const _NOEXCEPT
+            {
+                return static_cast<size_t>((__h * static_cast<size_t>(0x9E3779B97F4A7C15ULL))
+                                           >> (numeric_limits<size_t>::digits - __shift()));
+            }
+            template <class _Key>
+            uint32_t __find_index(const _Key& __k, size_t __h) const;
+            // Points at whichever index refers to element __i: its bucket head
+            // or its predecessor's __next_ entry.
+            uint32_t* __link_to(uint32_t __i) _NOEXCEPT;
+            void __rehash(size_type __nbc);
+        };
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Key>
+        uint32_t
+        __dense_hash_table<_Tp, _Hash, _Equal, _Alloc>::__find_index(const _Key& __k, size_t __h) const
+        {
+            if (__buckets_.empty())
+                return __npos;
+            uint32_t __i = __buckets_[__bucket(__h)];
+            while (__i != __npos && !key_eq()(__values_[__i], __k))
+                __i = __next_[__i];
+            return __i;
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        uint32_t*
+        __dense_hash_table<_Tp, _Hash, _Equal, _Alloc>::__link_to(uint32_t __i) _NOEXCEPT
+        {
+            uint32_t* __l = _VSTD::addressof(__buckets_[__bucket(hash_function()(__values_[__i]))]);
+            while (*__l != __i)
+                __l = _VSTD::addressof(__next_[*__l]);
+            return __l;
+        }
+
+        // Makes room in both vectors before touching either, so a throwing
+        // allocation or element constructor leaves the table as it was.
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Vp>
+        pair<typename __dense_hash_table<_Tp, _Hash, _Equal, _Alloc>::iterator, bool>
+        __dense_hash_table<_Tp, _Hash, _Equal, _Alloc>::__insert_unique(_Vp&& __v)
+        {
+            size_t __h = hash_function()(__v);
+            uint32_t __i = __find_index(__v, __h);
+            if (__i != __npos)
+                return pair<iterator, bool>(begin() + __i, false);
+            size_type __n = size();
+            if (__n + 1 > max_size())
+                __throw_length_error("unordered container: too many elements for 32-bit links");
+            if (__n + 1 > bucket_count() * max_load_factor())
+                rehash(_VSTD::max<size_type>(2 * bucket_count(),
+                                             size_type(ceil(float(__n + 1) / max_load_factor()))));
+            if (__n == __next_.capacity())
+                __next_.reserve(_VSTD::max<size_type>(2 * __n, 8));
+            __values_.push_back(_VSTD::forward<_Vp>(__v));
+            uint32_t& __head = __buckets_[__bucket(__h)];
+            __next_.push_back(__head);
+            __head = static_cast<uint32_t>(__n);
+            return pair<iterator, bool>(begin() + __n, true);
+        }
+
+        // The element is unlinked, then the last element is moved into its
+        // slot and whatever referred to the last index is pointed at the slot.
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        typename __dense_hash_table<_Tp, _Hash, _Equal, _Alloc>::iterator
+        __dense_hash_table<_Tp, _Hash, _Equal, _Alloc>::erase(const_iterator __p)
+        {
+            uint32_t __i = static_cast<uint32_t>(__p - begin());
+            uint32_t __last = static_cast<uint32_t>(size() - 1);
+            uint32_t* __l = __link_to(__i);
+            *__l = __next_[__i];
+            if (__i != __last)
+            {
+                __l = __link_to(__last);
+                *__l = __i;
+                __next_[__i] = __next_[__last];
+                __values_[__i] = _VSTD::move(__values_[__last]);
+            }
+            __values_.pop_back();
+            __next_.pop_back();
+            return begin() + __i;
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        typename __dense_hash_table<_Tp, _Hash, _Equal, _Alloc>::iterator
+        __dense_hash_table<_Tp, _Hash, _Equal, _Alloc>::erase(const_iterator __first,
+                                                              const_iterator __last)
+        {
+            // From the back, so the elements moved into holes come from
+            // outside the range.
+            difference_type __b = __first - begin();
+            for (difference_type __e = __last - begin(); __e != __b; )
+                erase(begin() + --__e);
+            return begin() + __b;
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Key>
+        typename __dense_hash_table<_Tp, _Hash, _Equal, _Alloc>::size_type
+        __dense_hash_table<_Tp, _Hash, _Equal, _Alloc>::__erase_unique(const _Key& __k)
+        {
+            uint32_t __i = __find_index(__k, hash_function()(__k));
+            if (__i == __npos)
+                return 0;
+            erase(begin() + __i);
+            return 1;
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        void
+        __dense_hash_table<_Tp, _Hash, _Equal, _Alloc>::rehash(size_type __n)
+        {
+            size_type __need = static_cast<size_type>(ceil(float(size()) / max_load_factor()));
+            __n = _VSTD::max(__n, __need);
+            // At least two buckets, so the shift in __bucket stays below the width.
+            size_type __nbc = __n == 0 ? 0 :
+                    __n <= 2 ? 2 : size_type(1) << (numeric_limits<size_t>::digits - __clz(__n - 1));
+            if (__nbc != bucket_count())
+                __rehash(__nbc);
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        void
+        __dense_hash_table<_Tp, _Hash, _Equal, _Alloc>::__rehash(size_type __nbc)
+        {
+            __index_list __b(__nbc, __npos, __buckets_.get_allocator());
+            __buckets_.swap(__b);
+            __shift() = __nbc != 0 ? numeric_limits<size_t>::digits - 1 - __clz(__nbc) : 0;
+            uint32_t __n = static_cast<uint32_t>(size());
+            for (uint32_t __i = 0; __i < __n; ++__i)
+            {
+                uint32_t& __head = __buckets_[__bucket(hash_function()(__values_[__i]))];
+                __next_[__i] = __head;
+                __head = __i;
+            }
+        }
+        // END CODE
+
+#endif  // _LIBCPP_CXX03_LANG
+
+_LIBCPP_END_NAMESPACE_STD
+
+#endif  // _LIBCPP__DENSE_HASH_TABLE
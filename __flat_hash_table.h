@@ -0,0 +1,1007 @@
+// -*- C++ -*-
+//===----------------------------------------------------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is dual licensed under the MIT and the University of Illinois Open
+// Source Licenses. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _LIBCPP__FLAT_HASH_TABLE
+#define _LIBCPP__FLAT_HASH_TABLE
+
+#include <__config>
+#include <initializer_list>
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <utility>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <__undef_min_max>
+
+#include <__debug>
+
+#if !defined(_LIBCPP_HAS_NO_PRAGMA_SYSTEM_HEADER)
+#pragma GCC system_header
+#endif
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+
+#ifndef _LIBCPP_CXX03_LANG
+
+        // START ADDED CODE
+        // Open-addressing engine in the style of Swiss tables. Elements live
+        // directly in a slot array; a parallel array of one-byte control tags
+        // says which slots are full and, for full ones, holds seven bits of the
+        // hash. A lookup compares sixteen tags at a time and touches a slot only
+        // when its tag matches, so a hit usually costs one miss on the tags and
+        // one on the slot. Unlike __hash_table, rehashing moves the elements, so
+        // references and pointers to them are invalidated as well as iterators.
+
+        // Control tag values. Full slots hold 0..127; everything else is
+        // negative, and __flat_sentinel is the only negative value that is not
+        // free for insertion.
+        enum
+        {
+            __flat_empty    = -128,
+            __flat_deleted  = -2,
+            __flat_sentinel = -1
+        };
+
+        // Sixteen control tags examined together. Bit __i of every mask stands
+        // for the tag at offset __i.
+        class __flat_group
+        {
+#if defined(__SSE2__)
+            __m128i __ctrl_;
+#else
+            signed char __ctrl_[16];
+#endif
+
+        public:
+            enum {__width = 16};
+
+            _LIBCPP_INLINE_VISIBILITY
+            explicit __flat_group(const signed char* __p) _NOEXCEPT
+            {
+#if defined(__SSE2__)
+                __ctrl_ = _mm_loadu_si128(reinterpret_cast<const __m128i*>(__p));
+#else
+                _VSTD::memcpy(__ctrl_, __p, __width);
+#endif
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            uint32_t __match(signed char __h) const _NOEXCEPT
+            {
+#if defined(__SSE2__)
+                return static_cast<uint32_t>(
+                        _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(__h), __ctrl_)));
+#else
+                uint32_t __m = 0;
+                for (int __i = 0; __i < __width; ++__i)
+                    __m |= static_cast<uint32_t>(__ctrl_[__i] == __h) << __i;
+                return __m;
+#endif
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            uint32_t __match_empty() const _NOEXCEPT
+            {
+                return __match(static_cast<signed char>(__flat_empty));
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            uint32_t __match_empty_or_deleted() const _NOEXCEPT
+            {
+#if defined(__SSE2__)
+                return static_cast<uint32_t>(_mm_movemask_epi8(
+                        _mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(__flat_sentinel)), __ctrl_)));
+#else
+                uint32_t __m = 0;
+                for (int __i = 0; __i < __width; ++__i)
+                    __m |= static_cast<uint32_t>(__ctrl_[__i] < __flat_sentinel) << __i;
+                return __m;
+#endif
+            }
+        };
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc> class __flat_hash_table;
+
+        template <class _Tp>
+        class _LIBCPP_TEMPLATE_VIS __flat_hash_const_iterator
+        {
+            const signed char* __ctrl_;
+            const _Tp*         __slot_;
+
+        public:
+            typedef forward_iterator_tag iterator_category;
+            typedef _Tp                  value_type;
+            typedef ptrdiff_t            difference_type;
+            typedef const value_type&    reference;
+            typedef const value_type*    pointer;
+
+            _LIBCPP_INLINE_VISIBILITY
+            __flat_hash_const_iterator() _NOEXCEPT : __ctrl_(nullptr), __slot_(nullptr) {}
+
+            _LIBCPP_INLINE_VISIBILITY
+            reference operator*() const {return *__slot_;}
+            _LIBCPP_INLINE_VISIBILITY
+            pointer operator->() const {return __slot_;}
+
+            _LIBCPP_INLINE_VISIBILITY
+            __flat_hash_const_iterator& operator++()
+            {
+                ++__ctrl_;
+                ++__slot_;
+                __skip_free();
+                return *this;
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            __flat_hash_const_iterator operator++(int)
+            {
+                __flat_hash_const_iterator __t(*this);
+                ++(*this);
+                return __t;
+            }
+
+            friend _LIBCPP_INLINE_VISIBILITY
+            bool operator==(const __flat_hash_const_iterator& __x, const __flat_hash_const_iterator& __y)
+            {
+                return __x.__ctrl_ == __y.__ctrl_;
+            }
+            friend _LIBCPP_INLINE_VISIBILITY
+            bool operator!=(const __flat_hash_const_iterator& __x, const __flat_hash_const_iterator& __y)
+            {return !(__x == __y);}
+
+        private:
+            _LIBCPP_INLINE_VISIBILITY
+            __flat_hash_const_iterator(const signed char* __ctrl, const _Tp* __slot) _NOEXCEPT
+                    : __ctrl_(__ctrl), __slot_(__slot) {}
+
+            // Moves forward to the next full slot or to the sentinel. The tag
+            // array has __flat_group::__width - 1 readable bytes past the
+            // sentinel, so a whole group can be loaded from any slot.
+            _LIBCPP_INLINE_VISIBILITY
+            void __skip_free() _NOEXCEPT
+            {
+                while (*__ctrl_ < __flat_sentinel)
+                {
+                    uint32_t __m = __flat_group(__ctrl_).__match_empty_or_deleted();
+                    unsigned __n = __ctz(~__m);
+                    __ctrl_ += __n;
+                    __slot_ += __n;
+                }
+            }
+
+            template <class, class, class, class> friend class __flat_hash_table;
+        };
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        class __flat_hash_table
+        {
+        public:
+            typedef _Tp    value_type;
+            typedef _Hash  hasher;
+            typedef _Equal key_equal;
+            typedef _Alloc allocator_type;
+
+        private:
+            typedef allocator_traits<allocator_type> __alloc_traits;
+            typedef typename __rebind_alloc_helper<__alloc_traits, signed char>::type __ctrl_allocator;
+            typedef allocator_traits<__ctrl_allocator> __ctrl_traits;
+            typedef typename __ctrl_traits::pointer __ctrl_pointer;
+
+        public:
+            typedef value_type&                              reference;
+            typedef const value_type&                        const_reference;
+            typedef typename __alloc_traits::pointer         pointer;
+            typedef typename __alloc_traits::const_pointer   const_pointer;
+            typedef typename __alloc_traits::size_type       size_type;
+            typedef typename __alloc_traits::difference_type difference_type;
+
+            typedef __flat_hash_const_iterator<value_type> const_iterator;
+            typedef const_iterator                         iterator;
+
+        private:
+            // --- Member data begin ---
+            __ctrl_pointer                                    __ctrl_;
+            pointer                                           __slots_;
+            // 0 or 2^k - 1 with k >= 4, so a group never wraps more than once.
+            size_type                                         __capacity_;
+            // Insertions left before the table has to grow; tombstones count
+            // against it, which keeps at least one empty tag on every probe path.
+            size_type                                         __growth_left_;
+            __compressed_pair<size_type, hasher>              __p1_;
+            __compressed_pair<float, key_equal>               __p2_;
+            __compressed_pair<size_type, __ctrl_allocator>    __p3_;
+            // --- Member data end ---
+
+            _LIBCPP_INLINE_VISIBILITY
+            size_type& __size() _NOEXCEPT {return __p1_.first();}
+            _LIBCPP_INLINE_VISIBILITY
+            __ctrl_allocator& __ctrl_alloc() _NOEXCEPT {return __p3_.second();}
+            _LIBCPP_INLINE_VISIBILITY
+            const __ctrl_allocator& __ctrl_alloc() const _NOEXCEPT {return __p3_.second();}
+
+        public:
+            _LIBCPP_INLINE_VISIBILITY
+            size_type size() const _NOEXCEPT {return __p1_.first();}
+            _LIBCPP_INLINE_VISIBILITY
+            hasher& hash_function() _NOEXCEPT {return __p1_.second();}
+            _LIBCPP_INLINE_VISIBILITY
+            const hasher& hash_function() const _NOEXCEPT {return __p1_.second();}
+            _LIBCPP_INLINE_VISIBILITY
+            key_equal& key_eq() _NOEXCEPT {return __p2_.second();}
+            _LIBCPP_INLINE_VISIBILITY
+            const key_equal& key_eq() const _NOEXCEPT {return __p2_.second();}
+            _LIBCPP_INLINE_VISIBILITY
+            allocator_type __alloc() const _NOEXCEPT {return allocator_type(__ctrl_alloc());}
+
+            __flat_hash_table()
+                _NOEXCEPT_(
+                    is_nothrow_default_constructible<hasher>::value &&
+                    is_nothrow_default_constructible<key_equal>::value &&
+                    is_nothrow_default_constructible<__ctrl_allocator>::value);
+            __flat_hash_table(const hasher& __hf, const key_equal& __eql);
+            __flat_hash_table(const hasher& __hf, const key_equal& __eql,
+                              const allocator_type& __a);
+            explicit __flat_hash_table(const allocator_type& __a);
+            __flat_hash_table(const __flat_hash_table& __u);
+            __flat_hash_table(const __flat_hash_table& __u, const allocator_type& __a);
+            __flat_hash_table(__flat_hash_table&& __u)
+                _NOEXCEPT_(
+                    is_nothrow_move_constructible<hasher>::value &&
+                    is_nothrow_move_constructible<key_equal>::value &&
+                    is_nothrow_move_constructible<__ctrl_allocator>::value);
+            __flat_hash_table(__flat_hash_table&& __u, const allocator_type& __a);
+            ~__flat_hash_table();
+
+            __flat_hash_table& operator=(const __flat_hash_table& __u);
+            __flat_hash_table& operator=(__flat_hash_table&& __u)
+                _NOEXCEPT_(
+                    __ctrl_traits::propagate_on_container_move_assignment::value &&
+                    is_nothrow_move_assignable<__ctrl_allocator>::value &&
+                    is_nothrow_move_assignable<hasher>::value &&
+                    is_nothrow_move_assignable<key_equal>::value);
+
+            _LIBCPP_INLINE_VISIBILITY
+            size_type max_size() const _NOEXCEPT
+            {
+                return _VSTD::min<size_type>(
+                    __alloc_traits::max_size(allocator_type(__ctrl_alloc())),
+                    numeric_limits<difference_type >::max()
+                );
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            const_iterator begin() const _NOEXCEPT
+            {
+                if (__capacity_ == 0)
+                    return end();
+                const_iterator __i(_VSTD::addressof(__ctrl_[0]), _VSTD::addressof(__slots_[0]));
+                __i.__skip_free();
+                return __i;
+            }
+            _LIBCPP_INLINE_VISIBILITY
+            const_iterator end() const _NOEXCEPT
+            {
+                if (__capacity_ == 0)
+                    return const_iterator();
+                return const_iterator(_VSTD::addressof(__ctrl_[__capacity_]),
+                                      _VSTD::addressof(__slots_[0]) + __capacity_);
+            }
+
+            template <class _Key>
+            const_iterator find(const _Key& __k) const;
+            template <class _Key>
+            _LIBCPP_INLINE_VISIBILITY
+            size_type __count_unique(const _Key& __k) const {return find(__k) != end();}
+
+            template <class _Vp>
+            pair<iterator, bool> __insert_unique(_Vp&& __v);
+            template <class... _Args>
+            pair<iterator, bool> __emplace_unique(_Args&&... __args);
+
+            iterator erase(const_iterator __p);
+            iterator erase(const_iterator __first, const_iterator __last);
+            template <class _Key>
+            size_type __erase_unique(const _Key& __k);
+            void clear() _NOEXCEPT;
+
+            void swap(__flat_hash_table& __u)
+#if _LIBCPP_STD_VER <= 11
+                _NOEXCEPT_DEBUG_(
+                    __is_nothrow_swappable<hasher>::value && __is_nothrow_swappable<key_equal>::value
+                    && (!__ctrl_traits::propagate_on_container_swap::value
+                        || __is_nothrow_swappable<__ctrl_allocator>::value)
+                );
+#else
+                _NOEXCEPT_DEBUG_(__is_nothrow_swappable<hasher>::value && __is_nothrow_swappable<key_equal>::value);
+#endif
+
+            // The bucket interface maps onto slots: bucket_count() is the number
+            // of slots, and max_load_factor() is advisory, as the standard
+            // allows; the table always grows at 7/8 full.
+            _LIBCPP_INLINE_VISIBILITY
+            size_type bucket_count() const _NOEXCEPT {return __capacity_;}
+            _LIBCPP_INLINE_VISIBILITY
+            float load_factor() const _NOEXCEPT
+            {
+                size_type __bc = bucket_count();
+                return __bc != 0 ? (float)size() / __bc : 0.f;
+            }
+            _LIBCPP_INLINE_VISIBILITY
+            float max_load_factor() const _NOEXCEPT {return __p2_.first();}
+            _LIBCPP_INLINE_VISIBILITY
+            void max_load_factor(float __mlf) _NOEXCEPT
+            {
+                _LIBCPP_ASSERT(__mlf > 0,
+                    "unordered container::max_load_factor(lf) called with lf <= 0");
+                __p2_.first() = __mlf;
+            }
+            void rehash(size_type __n);
+            _LIBCPP_INLINE_VISIBILITY
+            void reserve(size_type __n) {rehash(__growth_to_capacity(__n));}
+
+        private:
+            // Spreads the user hash so both halves are useful: the low seven bits
+            // become the tag and the rest picks the first group to probe.
+            _LIBCPP_INLINE_VISIBILITY
+            static size_t __mix(size_t __h) _NOEXCEPT
+            {
+                __h *= static_cast<size_t>(0x9E3779B97F4A7C15ULL);
+                return __h ^ (__h >> (numeric_limits<size_t>::digits / 2));
+            }
+            template <class _Key>
+            _LIBCPP_INLINE_VISIBILITY
+            size_t __hash(const _Key& __k) const {return __mix(hash_function()(__k));}
+            _LIBCPP_INLINE_VISIBILITY
+            static signed char __h2(size_t __h) _NOEXCEPT {return static_cast<signed char>(__h & 0x7F);}
+
+            _LIBCPP_INLINE_VISIBILITY
+            static size_type __capacity_to_growth(size_type __cap) _NOEXCEPT
+            {return __cap - __cap / 8;}
+            static size_type __growth_to_capacity(size_type __n) _NOEXCEPT;
+            static size_type __normalize_capacity(size_type __n) _NOEXCEPT;
+
+            _LIBCPP_INLINE_VISIBILITY
+            const_iterator __iterator_at(size_type __i) const _NOEXCEPT
+            {
+                return const_iterator(_VSTD::addressof(__ctrl_[__i]), _VSTD::addressof(__slots_[__i]));
+            }
+            _LIBCPP_INLINE_VISIBILITY
+            __flat_group __group_at(size_type __i) const _NOEXCEPT
+            {return __flat_group(_VSTD::addressof(__ctrl_[__i]));}
+            // Writes the tag of slot __i and, for the first __width - 1 slots, its
+            // copy past the sentinel.
+            _LIBCPP_INLINE_VISIBILITY
+            void __set_ctrl(size_type __i, signed char __h) _NOEXCEPT
+            {
+                __ctrl_[__i] = __h;
+                __ctrl_[((__i - (__flat_group::__width - 1)) & __capacity_) +
+                        (__flat_group::__width - 1)] = __h;
+            }
+            size_type __find_first_non_full(size_t __h) const _NOEXCEPT;
+            template <class _Key>
+            pair<size_type, bool> __find_or_prepare_insert(const _Key& __k, size_t __h);
+            void __grow_for_insert();
+            void __resize(size_type __new_capacity);
+            void __erase_at(size_type __i) _NOEXCEPT;
+            void __deallocate() _NOEXCEPT;
+            void __copy_from(const __flat_hash_table& __u);
+            void __move_assign(__flat_hash_table& __u, true_type)
+                _NOEXCEPT_(
+                    is_nothrow_move_assignable<__ctrl_allocator>::value &&
+                    is_nothrow_move_assignable<hasher>::value &&
+                    is_nothrow_move_assignable<key_equal>::value);
+            void __move_assign(__flat_hash_table& __u, false_type);
+            void __steal(__flat_hash_table& __u) _NOEXCEPT;
+        };
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        inline
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::__flat_hash_table()
+        _NOEXCEPT_(
+                is_nothrow_default_constructible<hasher>::value &&
+                is_nothrow_default_constructible<key_equal>::value &&
+                is_nothrow_default_constructible<__ctrl_allocator>::value)
+                : __ctrl_(nullptr),
+                  __slots_(nullptr),
+                  __capacity_(0),
+                  __growth_left_(0),
+                  __p1_(0),
+                  __p2_(0.875f),
+                  __p3_(0)
+        {
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        inline
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::__flat_hash_table(const hasher& __hf,
+                                                                         const key_equal& __eql)
+                : __ctrl_(nullptr),
+                  __slots_(nullptr),
+                  __capacity_(0),
+                  __growth_left_(0),
+                  __p1_(0, __hf),
+                  __p2_(0.875f, __eql),
+                  __p3_(0)
+        {
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::__flat_hash_table(const hasher& __hf,
+                                                                         const key_equal& __eql,
+                                                                         const allocator_type& __a)
+                : __ctrl_(nullptr),
+                  __slots_(nullptr),
+                  __capacity_(0),
+                  __growth_left_(0),
+                  __p1_(0, __hf),
+                  __p2_(0.875f, __eql),
+                  __p3_(0, __ctrl_allocator(__a))
+        {
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::__flat_hash_table(const allocator_type& __a)
+                : __ctrl_(nullptr),
+                  __slots_(nullptr),
+                  __capacity_(0),
+                  __growth_left_(0),
+                  __p1_(0),
+                  __p2_(0.875f),
+                  __p3_(0, __ctrl_allocator(__a))
+        {
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::__flat_hash_table(const __flat_hash_table& __u)
+                : __ctrl_(nullptr),
+                  __slots_(nullptr),
+                  __capacity_(0),
+                  __growth_left_(0),
+                  __p1_(0, __u.hash_function()),
+                  __p2_(__u.max_load_factor(), __u.key_eq()),
+                  __p3_(0, __ctrl_traits::select_on_container_copy_construction(__u.__ctrl_alloc()))
+        {
+            __copy_from(__u);
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::__flat_hash_table(const __flat_hash_table& __u,
+                                                                         const allocator_type& __a)
+                : __ctrl_(nullptr),
+                  __slots_(nullptr),
+                  __capacity_(0),
+                  __growth_left_(0),
+                  __p1_(0, __u.hash_function()),
+                  __p2_(__u.max_load_factor(), __u.key_eq()),
+                  __p3_(0, __ctrl_allocator(__a))
+        {
+            __copy_from(__u);
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::__flat_hash_table(__flat_hash_table&& __u)
+        _NOEXCEPT_(
+                is_nothrow_move_constructible<hasher>::value &&
+                is_nothrow_move_constructible<key_equal>::value &&
+                is_nothrow_move_constructible<__ctrl_allocator>::value)
+                : __ctrl_(__u.__ctrl_),
+                  __slots_(__u.__slots_),
+                  __capacity_(__u.__capacity_),
+                  __growth_left_(__u.__growth_left_),
+                  __p1_(_VSTD::move(__u.__p1_)),
+                  __p2_(_VSTD::move(__u.__p2_)),
+                  __p3_(_VSTD::move(__u.__p3_))
+        {
+            __u.__ctrl_ = nullptr;
+            __u.__slots_ = nullptr;
+            __u.__capacity_ = 0;
+            __u.__growth_left_ = 0;
+            __u.__size() = 0;
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::__flat_hash_table(__flat_hash_table&& __u,
+                                                                         const allocator_type& __a)
+                : __ctrl_(nullptr),
+                  __slots_(nullptr),
+                  __capacity_(0),
+                  __growth_left_(0),
+                  __p1_(0, _VSTD::move(__u.hash_function())),
+                  __p2_(__u.max_load_factor(), _VSTD::move(__u.key_eq())),
+                  __p3_(0, __ctrl_allocator(__a))
+        {
+            if (__ctrl_alloc() == __u.__ctrl_alloc())
+                __steal(__u);
+            else
+            {
+                reserve(__u.size());
+                for (const_iterator __i = __u.begin(); __i != __u.end(); ++__i)
+                    __insert_unique(_VSTD::move(const_cast<value_type&>(*__i)));
+                __u.clear();
+            }
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::~__flat_hash_table()
+        {
+            __deallocate();
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>&
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::operator=(const __flat_hash_table& __u)
+        {
+            if (this != &__u)
+            {
+                __deallocate();
+                hash_function() = __u.hash_function();
+                key_eq() = __u.key_eq();
+                __p2_.first() = __u.max_load_factor();
+                if (__ctrl_traits::propagate_on_container_copy_assignment::value)
+                    __ctrl_alloc() = __u.__ctrl_alloc();
+                __copy_from(__u);
+            }
+            return *this;
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        inline
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>&
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::operator=(__flat_hash_table&& __u)
+        _NOEXCEPT_(
+                __ctrl_traits::propagate_on_container_move_assignment::value &&
+                is_nothrow_move_assignable<__ctrl_allocator>::value &&
+                is_nothrow_move_assignable<hasher>::value &&
+                is_nothrow_move_assignable<key_equal>::value)
+        {
+            __move_assign(__u, integral_constant<bool,
+                          __ctrl_traits::propagate_on_container_move_assignment::value>());
+            return *this;
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        void
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::__move_assign(__flat_hash_table& __u, true_type)
+        _NOEXCEPT_(
+                is_nothrow_move_assignable<__ctrl_allocator>::value &&
+                is_nothrow_move_assignable<hasher>::value &&
+                is_nothrow_move_assignable<key_equal>::value)
+        {
+            __deallocate();
+            hash_function() = _VSTD::move(__u.hash_function());
+            key_eq() = _VSTD::move(__u.key_eq());
+            __p2_.first() = __u.max_load_factor();
+            __ctrl_alloc() = _VSTD::move(__u.__ctrl_alloc());
+            __steal(__u);
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        void
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::__move_assign(__flat_hash_table& __u, false_type)
+        {
+            __deallocate();
+            hash_function() = _VSTD::move(__u.hash_function());
+            key_eq() = _VSTD::move(__u.key_eq());
+            __p2_.first() = __u.max_load_factor();
+            if (__ctrl_alloc() == __u.__ctrl_alloc())
+                __steal(__u);
+            else
+            {
+                reserve(__u.size());
+                for (const_iterator __i = __u.begin(); __i != __u.end(); ++__i)
+                    __insert_unique(_VSTD::move(const_cast<value_type&>(*__i)));
+                __u.clear();
+            }
+        }
+
+        // Takes __u's arrays; *this must own none.
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        void
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::__steal(__flat_hash_table& __u) _NOEXCEPT
+        {
+            __ctrl_ = __u.__ctrl_;
+            __slots_ = __u.__slots_;
+            __capacity_ = __u.__capacity_;
+            __growth_left_ = __u.__growth_left_;
+            __size() = __u.size();
+            __u.__ctrl_ = nullptr;
+            __u.__slots_ = nullptr;
+            __u.__capacity_ = 0;
+            __u.__growth_left_ = 0;
+            __u.__size() = 0;
+        }
+
+        // Inserts every element of __u into a table that owns no arrays. The
+        // keys are known to be distinct, so each goes straight to a free slot.
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        void
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::__copy_from(const __flat_hash_table& __u)
+        {
+            if (__u.size() == 0)
+                return;
+            __resize(__growth_to_capacity(__u.size()));
+            allocator_type __a(__ctrl_alloc());
+            for (const_iterator __i = __u.begin(); __i != __u.end(); ++__i)
+            {
+                size_t __h = __hash(*__i);
+                size_type __j = __find_first_non_full(__h);
+                __alloc_traits::construct(__a, _VSTD::addressof(__slots_[__j]), *__i);
+                __set_ctrl(__j, __h2(__h));
+                ++__size();
+                --__growth_left_;
+            }
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        void
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::__deallocate() _NOEXCEPT
+        {
+            if (__capacity_ == 0)
+                return;
+            clear();
+            allocator_type __a(__ctrl_alloc());
+            __alloc_traits::deallocate(__a, __slots_, __capacity_);
+            __ctrl_traits::deallocate(__ctrl_alloc(), __ctrl_, __capacity_ + __flat_group::__width);
+            __ctrl_ = nullptr;
+            __slots_ = nullptr;
+            __capacity_ = 0;
+            __growth_left_ = 0;
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        typename __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::size_type
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::__normalize_capacity(size_type __n) _NOEXCEPT
+        {
+            size_type __cap = __flat_group::__width - 1;
+            while (__cap < __n)
+                __cap = __cap * 2 + 1;
+            return __cap;
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        typename __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::size_type
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::__growth_to_capacity(size_type __n) _NOEXCEPT
+        {
+            if (__n == 0)
+                return 0;
+            size_type __cap = __normalize_capacity(__n);
+            while (__capacity_to_growth(__cap) < __n)
+                __cap = __cap * 2 + 1;
+            return __cap;
+        }
+
+        // Triangular probing over groups: offsets 0, 16, 48, 96, ... from the
+        // home position visit every group once because the slot count is a
+        // power of two.
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Key>
+        typename __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::const_iterator
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::find(const _Key& __k) const
+        {
+            if (size() == 0)
+                return end();
+            size_t __h = __hash(__k);
+            signed char __tag = __h2(__h);
+            size_type __pos = (__h >> 7) & __capacity_;
+            for (size_type __step = __flat_group::__width; ; __step += __flat_group::__width)
+            {
+                __flat_group __g = __group_at(__pos);
+                for (uint32_t __m = __g.__match(__tag); __m != 0; __m &= __m - 1)
+                {
+                    size_type __i = (__pos + __ctz(__m)) & __capacity_;
+                    if (key_eq()(__slots_[__i], __k))
+                        return __iterator_at(__i);
+                }
+                if (__g.__match_empty() != 0)
+                    return end();
+                __pos = (__pos + __step) & __capacity_;
+            }
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        typename __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::size_type
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::__find_first_non_full(size_t __h) const _NOEXCEPT
+        {
+            size_type __pos = (__h >> 7) & __capacity_;
+            for (size_type __step = __flat_group::__width; ; __step += __flat_group::__width)
+            {
+                uint32_t __m = __group_at(__pos).__match_empty_or_deleted();
+                if (__m != 0)
+                    return (__pos + __ctz(__m)) & __capacity_;
+                __pos = (__pos + __step) & __capacity_;
+            }
+        }
+
+        // Returns the slot holding __k and true, or a free slot for __k and
+        // false. A free slot is only handed out once growth has been paid for.
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Key>
+        pair<typename __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::size_type, bool>
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::__find_or_prepare_insert(const _Key& __k,
+                                                                                size_t __h)
+        {
+            if (__capacity_ != 0)
+            {
+                signed char __tag = __h2(__h);
+                size_type __pos = (__h >> 7) & __capacity_;
+                for (size_type __step = __flat_group::__width; ; __step += __flat_group::__width)
+                {
+                    __flat_group __g = __group_at(__pos);
+                    for (uint32_t __m = __g.__match(__tag); __m != 0; __m &= __m - 1)
+                    {
+                        size_type __i = (__pos + __ctz(__m)) & __capacity_;
+                        if (key_eq()(__slots_[__i], __k))
+                            return pair<size_type, bool>(__i, true);
+                    }
+                    if (__g.__match_empty() != 0)
+                        break;
+                    __pos = (__pos + __step) & __capacity_;
+                }
+            }
+            size_type __i = __capacity_ != 0 ? __find_first_non_full(__h) : 0;
+            if (__growth_left_ == 0 && (__capacity_ == 0 || __ctrl_[__i] != __flat_deleted))
+            {
+                __grow_for_insert();
+                __i = __find_first_non_full(__h);
+            }
+            return pair<size_type, bool>(__i, false);
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Vp>
+        pair<typename __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::iterator, bool>
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::__insert_unique(_Vp&& __v)
+        {
+            size_t __h = __hash(__v);
+            pair<size_type, bool> __r = __find_or_prepare_insert(__v, __h);
+            if (!__r.second)
+            {
+                allocator_type __a(__ctrl_alloc());
+                __alloc_traits::construct(__a, _VSTD::addressof(__slots_[__r.first]),
+                                          _VSTD::forward<_Vp>(__v));
+                if (__ctrl_[__r.first] == __flat_empty)
+                    --__growth_left_;
+                __set_ctrl(__r.first, __h2(__h));
+                ++__size();
+            }
+            return pair<iterator, bool>(__iterator_at(__r.first), !__r.second);
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class... _Args>
+        pair<typename __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::iterator, bool>
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::__emplace_unique(_Args&&... __args)
+        {
+            return __insert_unique(value_type(_VSTD::forward<_Args>(__args)...));
+        }
+
+        // A tombstone is needed only if some probe may have passed this slot
+        // looking for something further on, that is, if a run of at least
+        // __width full-or-deleted tags ever covered it. Otherwise the slot can
+        // go back to empty and the growth it used is returned.
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        void
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::__erase_at(size_type __i) _NOEXCEPT
+        {
+            allocator_type __a(__ctrl_alloc());
+            __alloc_traits::destroy(__a, _VSTD::addressof(__slots_[__i]));
+            --__size();
+            uint32_t __after = __group_at(__i).__match_empty();
+            uint32_t __before = __group_at((__i - __flat_group::__width) & __capacity_).__match_empty();
+            bool __never_full = __capacity_ < __flat_group::__width ||
+                    (__after != 0 && __before != 0 &&
+                     __ctz(__after) + (__clz(__before) - 16) < __flat_group::__width);
+            if (__never_full)
+            {
+                __set_ctrl(__i, static_cast<signed char>(__flat_empty));
+                ++__growth_left_;
+            }
+            else
+                __set_ctrl(__i, static_cast<signed char>(__flat_deleted));
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        typename __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::iterator
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::erase(const_iterator __p)
+        {
+            iterator __r = __p;
+            ++__r;
+            __erase_at(static_cast<size_type>(__p.__slot_ - _VSTD::addressof(__slots_[0])));
+            return __r;
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        typename __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::iterator
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::erase(const_iterator __first,
+                                                             const_iterator __last)
+        {
+            while (__first != __last)
+                __first = erase(__first);
+            return __last;
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Key>
+        typename __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::size_type
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::__erase_unique(const _Key& __k)
+        {
+            const_iterator __i = find(__k);
+            if (__i == end())
+                return 0;
+            erase(__i);
+            return 1;
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        void
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::clear() _NOEXCEPT
+        {
+            if (__capacity_ == 0)
+                return;
+            if (size() != 0)
+            {
+                allocator_type __a(__ctrl_alloc());
+                for (size_type __i = 0; __i < __capacity_; ++__i)
+                    if (__ctrl_[__i] >= 0)
+                        __alloc_traits::destroy(__a, _VSTD::addressof(__slots_[__i]));
+            }
+            _VSTD::memset(_VSTD::addressof(__ctrl_[0]), static_cast<signed char>(__flat_empty),
+                          __capacity_ + __flat_group::__width);
+            __ctrl_[__capacity_] = static_cast<signed char>(__flat_sentinel);
+            __size() = 0;
+            __growth_left_ = __capacity_to_growth(__capacity_);
+        }
+
+        // Grows by doubling, unless at least half of the allowed load is
+        // tombstones, in which case rebuilding at the same size clears them.
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        void
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::__grow_for_insert()
+        {
+            if (__capacity_ == 0)
+                __resize(__flat_group::__width - 1);
+            else if (size() <= __capacity_to_growth(__capacity_) / 2)
+                __resize(__capacity_);
+            else
+                __resize(__capacity_ * 2 + 1);
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        void
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::rehash(size_type __n)
+        {
+            size_type __cap = _VSTD::max(__growth_to_capacity(size()),
+                                         __n != 0 ? __normalize_capacity(__n) : 0);
+            if (__cap != __capacity_ || (__cap != 0 && __growth_left_ !=
+                                         __capacity_to_growth(__cap) - size()))
+                __resize(__cap);
+        }
+
+        // Moves every element into freshly allocated arrays of __new_capacity
+        // slots. If an element's move (or copy, for types whose move may throw)
+        // fails, the new arrays are released and the table is left unchanged.
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        void
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::__resize(size_type __new_capacity)
+        {
+            if (__new_capacity == 0)
+            {
+                __deallocate();
+                return;
+            }
+            allocator_type __a(__ctrl_alloc());
+            __ctrl_pointer __old_ctrl = __ctrl_;
+            pointer __old_slots = __slots_;
+            size_type __old_capacity = __capacity_;
+            __ctrl_pointer __new_ctrl =
+                    __ctrl_traits::allocate(__ctrl_alloc(), __new_capacity + __flat_group::__width);
+            pointer __new_slots;
+#ifndef _LIBCPP_NO_EXCEPTIONS
+            try
+            {
+#endif  // _LIBCPP_NO_EXCEPTIONS
+                __new_slots = __alloc_traits::allocate(__a, __new_capacity);
+#ifndef _LIBCPP_NO_EXCEPTIONS
+            }
+            catch (...)
+            {
+                __ctrl_traits::deallocate(__ctrl_alloc(), __new_ctrl,
+                                          __new_capacity + __flat_group::__width);
+                throw;
+            }
+#endif  // _LIBCPP_NO_EXCEPTIONS
+            _VSTD::memset(_VSTD::addressof(__new_ctrl[0]), static_cast<signed char>(__flat_empty),
+                          __new_capacity + __flat_group::__width);
+            __new_ctrl[__new_capacity] = static_cast<signed char>(__flat_sentinel);
+            __ctrl_ = __new_ctrl;
+            __slots_ = __new_slots;
+            __capacity_ = __new_capacity;
+            size_type __i = 0;
+#ifndef _LIBCPP_NO_EXCEPTIONS
+            try
+            {
+#endif  // _LIBCPP_NO_EXCEPTIONS
+                for (; __i < __old_capacity; ++__i)
+                {
+                    if (__old_ctrl[__i] < 0)
+                        continue;
+                    size_t __h = __hash(__old_slots[__i]);
+                    size_type __j = __find_first_non_full(__h);
+                    __alloc_traits::construct(__a, _VSTD::addressof(__slots_[__j]),
+                                              _VSTD::move_if_noexcept(__old_slots[__i]));
+                    __set_ctrl(__j, __h2(__h));
+                }
+#ifndef _LIBCPP_NO_EXCEPTIONS
+            }
+            catch (...)
+            {
+                for (size_type __j = 0; __j < __new_capacity; ++__j)
+                    if (__new_ctrl[__j] >= 0)
+                        __alloc_traits::destroy(__a, _VSTD::addressof(__new_slots[__j]));
+                __alloc_traits::deallocate(__a, __new_slots, __new_capacity);
+                __ctrl_traits::deallocate(__ctrl_alloc(), __new_ctrl,
+                                          __new_capacity + __flat_group::__width);
+                __ctrl_ = __old_ctrl;
+                __slots_ = __old_slots;
+                __capacity_ = __old_capacity;
+                throw;
+            }
+#endif  // _LIBCPP_NO_EXCEPTIONS
+            for (__i = 0; __i < __old_capacity; ++__i)
+                if (__old_ctrl[__i] >= 0)
+                    __alloc_traits::destroy(__a, _VSTD::addressof(__old_slots[__i]));
+            if (__old_capacity != 0)
+            {
+                __alloc_traits::deallocate(__a, __old_slots, __old_capacity);
+                __ctrl_traits::deallocate(__ctrl_alloc(), __old_ctrl,
+                                          __old_capacity + __flat_group::__width);
+            }
+            __growth_left_ = __capacity_to_growth(__capacity_) - size();
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        void
+        __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>::swap(__flat_hash_table& __u)
+#if _LIBCPP_STD_VER <= 11
+        _NOEXCEPT_DEBUG_(
+                __is_nothrow_swappable<hasher>::value && __is_nothrow_swappable<key_equal>::value
+                && (!__ctrl_traits::propagate_on_container_swap::value
+                    || __is_nothrow_swappable<__ctrl_allocator>::value)
+        )
+#else
+        _NOEXCEPT_DEBUG_(__is_nothrow_swappable<hasher>::value && __is_nothrow_swappable<key_equal>::value)
+#endif
+        {
+            _LIBCPP_ASSERT(__ctrl_traits::propagate_on_container_swap::value ||
+                           this->__ctrl_alloc() == __u.__ctrl_alloc(),
+                           "list::swap: Either propagate_on_container_swap must be true"
+                           " or the allocators must compare equal");
+            _VSTD::swap(__ctrl_, __u.__ctrl_);
+            _VSTD::swap(__slots_, __u.__slots_);
+            _VSTD::swap(__capacity_, __u.__capacity_);
+            _VSTD::swap(__growth_left_, __u.__growth_left_);
+            __p1_.swap(__u.__p1_);
+            __p2_.swap(__u.__p2_);
+            _VSTD::swap(__p3_.first(), __u.__p3_.first());
+            __swap_allocator(__ctrl_alloc(), __u.__ctrl_alloc());
+        }
+        // END CODE
+
+#endif  // _LIBCPP_CXX03_LANG
+
+_LIBCPP_END_NAMESPACE_STD
+
+#endif  // _LIBCPP__FLAT_HASH_TABLE
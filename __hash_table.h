@@ -17,7 +17,18 @@
 #include <iterator>
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
 #include <utility>
+#include <random>
+#include <vector>
+#ifndef _LIBCPP_HAS_NO_THREADS
+#include <thread>
+#endif
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
 
 #include <__undef_min_max>
 
@@ -76,67 +87,996 @@ struct __hash_value_type;
             __next_pointer    __next_;
 
             _LIBCPP_INLINE_VISIBILITY
-            __next_pointer __ptr() _NOEXCEPT {
-                return static_cast<__next_pointer>(
-                        pointer_traits<__node_base_pointer>::pointer_to(*this));
+            __next_pointer __ptr() _NOEXCEPT {
+                return static_cast<__next_pointer>(
+                        pointer_traits<__node_base_pointer>::pointer_to(*this));
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            __node_pointer __upcast() _NOEXCEPT {
+                return static_cast<__node_pointer>(
+                        pointer_traits<__node_base_pointer>::pointer_to(*this));
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            size_t __hash() const _NOEXCEPT {
+                return static_cast<__node_type const&>(*this).__hash_;
+            }
+
+            _LIBCPP_INLINE_VISIBILITY __hash_node_base() _NOEXCEPT : __next_(nullptr) {}
+        };
+
+        // Whether the nodes of a table keyed on _Key and hashed by _Hash store
+        // the hash of their value. Caching saves a call to the hasher on every
+        // rehash, erase and local-iterator step; dropping it saves a size_t per
+        // node. The default drops it only where std::hash is a cast or nearly
+        // so, i.e. integral, enum and pointer keys, so strings and user types
+        // keep theirs. Specialize it to opt a cheap hasher out; such a hasher
+        // must not throw when called or copied, since node removal and
+        // rehashing call it and bucket iterators carry a copy.
+        template <class _Key, class _Hash>
+        struct _LIBCPP_TEMPLATE_VIS cache_hash_code
+                : integral_constant<bool,
+                        !(is_same<_Hash, hash<_Key> >::value &&
+                          (is_integral<_Key>::value || is_enum<_Key>::value ||
+                           is_pointer<_Key>::value))> {};
+
+        // Which optional bucket-array machinery a table keyed on _Key and
+        // hashed by _Hash compiles in. Each member costs state in every such
+        // table, and most a branch on lookup, so all are off by default and
+        // a table is laid out and searched as plain libc++'s is; specialize
+        // the template with some of them true_type to opt in.
+        //   fast_modulo   prime bucket counts are reduced by a precomputed
+        //                 reciprocal instead of a division (16 bytes, also
+        //                 carried by bucket iterators)
+        //   pow2_mixing   enables bucket_pow2_mixing()
+        //   fingerprints  enables bucket_fingerprints()
+        //   huge_pages    enables bucket_huge_pages()
+        template <class _Key, class _Hash>
+        struct _LIBCPP_TEMPLATE_VIS hash_bucket_features
+        {
+            typedef false_type fast_modulo;
+            typedef false_type pow2_mixing;
+            typedef false_type fingerprints;
+            typedef false_type huge_pages;
+        };
+
+        template <class _Tp, class _VoidPtr, bool _CacheHash = true>
+        struct __hash_node
+                : public __hash_node_base
+                        <
+                                typename __rebind_pointer<_VoidPtr, __hash_node<_Tp, _VoidPtr, _CacheHash> >::type
+                        >
+        {
+            typedef _Tp __node_value_type;
+
+            size_t            __hash_;
+            __node_value_type __value_;
+        };
+
+        // The table recomputes the hash of these nodes from __value_, so
+        // __hash_node_base::__hash() must not be called on them.
+        template <class _Tp, class _VoidPtr>
+        struct __hash_node<_Tp, _VoidPtr, false>
+                : public __hash_node_base
+                        <
+                                typename __rebind_pointer<_VoidPtr, __hash_node<_Tp, _VoidPtr, false> >::type
+                        >
+        {
+            typedef _Tp __node_value_type;
+
+            __node_value_type __value_;
+        };
+
+        inline _LIBCPP_INLINE_VISIBILITY
+        bool
+        __is_hash_power2(size_t __bc)
+        {
+            return __bc > 2 && !(__bc & (__bc - 1));
+        }
+
+        inline _LIBCPP_INLINE_VISIBILITY
+        size_t
+        __constrain_hash(size_t __h, size_t __bc)
+        {
+            return !(__bc & (__bc - 1)) ? __h & (__bc - 1) :
+                   (__h < __bc ? __h : __h % __bc);
+        }
+
+#if defined(__SIZEOF_INT128__) && __SIZEOF_SIZE_T__ == 8
+#define _LIBCPP_HASH_FASTMOD
+#endif
+
+        // Reduction of a hash modulo a bucket count __d that is not a power of
+        // two. With _FastMod and a 128-bit type it is precomputed, so
+        // __constrain_hash costs four multiplies instead of a 64-bit division
+        // (Lemire, Kaser and Kurz, "Faster Remainder by Direct Computation",
+        // 2019): with __m_ = ceil(2^128 / __d), __h % __d is the high word of
+        // (__m_ * __h mod 2^128) * __d, for every 64-bit __h and __d > 1.
+        // Otherwise it is the division, and there is nothing to store.
+        template <bool _FastMod>
+        struct __hash_modulus
+        {
+            _LIBCPP_INLINE_VISIBILITY
+            __hash_modulus() _NOEXCEPT {}
+            _LIBCPP_INLINE_VISIBILITY
+            explicit __hash_modulus(size_t) _NOEXCEPT {}
+
+            _LIBCPP_INLINE_VISIBILITY
+            size_t __mod(size_t __h, size_t __d) const _NOEXCEPT
+            {
+                return __h < __d ? __h : __h % __d;
+            }
+        };
+
+#ifdef _LIBCPP_HASH_FASTMOD
+        template <>
+        struct __hash_modulus<true>
+        {
+            __uint128_t __m_;
+
+            _LIBCPP_INLINE_VISIBILITY
+            __hash_modulus() _NOEXCEPT : __m_(0) {}
+            _LIBCPP_INLINE_VISIBILITY
+            explicit __hash_modulus(size_t __d) _NOEXCEPT
+                    : __m_(__d & (__d - 1) ? ~__uint128_t(0) / __d + 1 : 0) {}
+
+            _LIBCPP_INLINE_VISIBILITY
+            size_t __mod(size_t __h, size_t __d) const _NOEXCEPT
+            {
+                __uint128_t __low = __m_ * __h;
+                __uint128_t __lo = (__low & ~uint64_t(0)) * __d;
+                __uint128_t __hi = (__low >> 64) * __d;
+                return static_cast<size_t>(((__lo >> 64) + __hi) >> 64);
+            }
+        };
+#endif
+
+        // Reduction of a hash modulo a power of two __d: the low bits, or,
+        // with _Mix and a __d built with __mix set, the top log2(__d) bits
+        // of __h times 2^N / phi (Fibonacci hashing), which spreads hashes
+        // that differ only in their high bits, such as strided integers or
+        // aligned pointers under the identity hash<>, where masking would
+        // pile them into a few buckets.
+        template <bool _Mix>
+        struct __hash_mixer
+        {
+            _LIBCPP_INLINE_VISIBILITY
+            __hash_mixer() _NOEXCEPT {}
+            _LIBCPP_INLINE_VISIBILITY
+            __hash_mixer(size_t, bool) _NOEXCEPT {}
+
+            _LIBCPP_INLINE_VISIBILITY
+            size_t __pow2(size_t __h, size_t __d) const _NOEXCEPT {return __h & (__d - 1);}
+        };
+
+        template <>
+        struct __hash_mixer<true>
+        {
+            unsigned __shift_;
+
+            _LIBCPP_INLINE_VISIBILITY
+            static unsigned __mix_shift(size_t __d, bool __mix) _NOEXCEPT
+            {
+                return __mix && __d > 1 && !(__d & (__d - 1)) ? 1 + __clz(__d) : 0;
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            static size_t __mix(size_t __h, unsigned __shift) _NOEXCEPT
+            {
+                return (__h * (sizeof(size_t) > 4 ? static_cast<size_t>(0x9E3779B97F4A7C15ULL)
+                                                  : static_cast<size_t>(0x9E3779B9u))) >> __shift;
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            __hash_mixer() _NOEXCEPT : __shift_(0) {}
+            _LIBCPP_INLINE_VISIBILITY
+            __hash_mixer(size_t __d, bool __mix) _NOEXCEPT : __shift_(__mix_shift(__d, __mix)) {}
+
+            _LIBCPP_INLINE_VISIBILITY
+            size_t __pow2(size_t __h, size_t __d) const _NOEXCEPT
+            {
+                return __shift_ ? __mix(__h, __shift_) : __h & (__d - 1);
+            }
+        };
+
+        // What __constrain_hash needs to know about a bucket count beyond
+        // the count itself. Both halves are empty unless the table's
+        // hash_bucket_features ask for them, and the holders derive from
+        // this, so by default it takes no space anywhere.
+        template <bool _FastMod = false, bool _Mix = false>
+        struct __hash_reciprocal
+                : __hash_modulus<_FastMod>,
+                  __hash_mixer<_Mix>
+        {
+            _LIBCPP_INLINE_VISIBILITY
+            __hash_reciprocal() _NOEXCEPT {}
+            _LIBCPP_INLINE_VISIBILITY
+            explicit __hash_reciprocal(size_t __d, bool __mix = false) _NOEXCEPT
+                    : __hash_modulus<_FastMod>(__d),
+                      __hash_mixer<_Mix>(__d, __mix) {}
+        };
+
+        // __constrain_hash for a bucket count whose reciprocal is __r.
+        template <bool _FastMod, bool _Mix>
+        inline _LIBCPP_INLINE_VISIBILITY
+        size_t
+        __constrain_hash(size_t __h, size_t __bc, const __hash_reciprocal<_FastMod, _Mix>& __r)
+        {
+            return !(__bc & (__bc - 1)) ? __r.__pow2(__h, __bc) : __r.__mod(__h, __bc);
+        }
+
+        // The smallest prime bucket count >= __n. Every prime up to 211 is in
+        // the table and above that they are about an eighth of a doubling
+        // apart, so the result can exceed the exact next prime by up to 11%;
+        // in exchange rehash() no longer calls out to the library's
+        // __next_prime, which trial-divides.
+        inline
+        size_t
+        __hash_next_prime(size_t __n)
+        {
+            static const uint64_t __primes[] =
+            {
+                2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61, 67, 71, 73, 79,
+                83, 89, 97, 101, 103, 107, 109, 113, 127, 131, 137, 139, 149, 151, 157, 163, 167,
+                173, 179, 181, 191, 193, 197, 199, 211, 233, 257, 281, 307, 337, 367, 397, 431, 479,
+                521, 563, 613, 673, 727, 797, 863, 941, 1031, 1117, 1223, 1361, 1451, 1583, 1723,
+                1879, 2053, 2237, 2437, 2657, 2897, 3163, 3449, 3761, 4099, 4481, 4871, 5323, 5801,
+                6317, 6899, 7517, 8209, 8941, 9743, 10627, 11587, 12637, 13781, 15031, 16411,
+                17881, 19489, 21269, 23173, 25301, 27581, 30059, 32771, 35747, 38971, 42499, 46349,
+                50539, 55109, 60101, 65537, 71471, 77951, 84991, 92683, 101081, 110221, 120199,
+                131101, 142939, 155887, 169987, 185369, 202183, 220447, 240421, 262147, 285871,
+                311747, 339959, 370759, 404291, 440893, 480787, 524309, 571741, 623521, 679919,
+                741457, 808579, 881779, 961549, 1048583, 1143481, 1246997, 1359857, 1482919,
+                1617137, 1763491, 1923107, 2097169, 2286961, 2493949, 2719699, 2965847, 3234251,
+                3526987, 3846197, 4194319, 4573931, 4987901, 5439341, 5931649, 6468509, 7053971,
+                7692389, 8388617, 9147857, 9975803, 10878709, 11863289, 12937007, 14107921,
+                15384821, 16777259, 18295687, 19951597, 21757361, 23726569, 25874027, 28215809,
+                30769567, 33554467, 36591383, 39903197, 43514717, 47453149, 51748043, 56431657,
+                61539113, 67108879, 73182743, 79806341, 87029471, 94906297, 103496027, 112863217,
+                123078209, 134217757, 146365487, 159612679, 174058861, 189812533, 206992043,
+                225726419, 246156401, 268435459, 292730989, 319225391, 348117739, 379625083,
+                413984099, 451452839, 492312797, 536870923, 585461917, 638450719, 696235447,
+                759250133, 827968151, 902905657, 984625687, 1073741827, 1170923777, 1276901429,
+                1392470869, 1518500279, 1655936281, 1805811341, 1969251217, 2147483659u,
+                2341847531u, 2553802871u, 2784941749u, 3037000507u, 3311872549u, 3611622607u,
+                3938502391u, 4294967311ULL, 4683695053ULL, 5107605691ULL, 5569883479ULL,
+                6074001001ULL, 6623745077ULL, 7223245229ULL, 7877004763ULL, 8589934609ULL,
+                9367390111ULL, 10215211387ULL, 11139766997ULL, 12148002047ULL, 13247490119ULL,
+                14446490449ULL, 15754009529ULL, 17179869209ULL, 18734780237ULL, 20430422699ULL,
+                22279533907ULL, 24296004011ULL, 26494980269ULL, 28892980877ULL, 31508019007ULL,
+                34359738421ULL, 37469560393ULL, 40860845437ULL, 44559067811ULL, 48592008053ULL,
+                52989960473ULL, 57785961671ULL, 63016038037ULL, 68719476767ULL, 74939120803ULL,
+                81721690807ULL, 89118135619ULL, 97184016049ULL, 105979920967ULL, 115571923303ULL,
+                126032076043ULL, 137438953481ULL, 149878241563ULL, 163443381373ULL,
+                178236271219ULL, 194368032011ULL, 211959841879ULL, 231143846587ULL,
+                252064152059ULL, 274877906951ULL, 299756483077ULL, 326886762733ULL,
+                356472542471ULL, 388736063999ULL, 423919683773ULL, 462287693167ULL,
+                504128304161ULL, 549755813911ULL, 599512966141ULL, 653773525393ULL,
+                712945084867ULL, 777472128049ULL, 847839367519ULL, 924575386373ULL,
+                1008256608223ULL, 1099511627791ULL, 1199025932267ULL, 1307547050819ULL,
+                1425890169749ULL, 1554944255989ULL, 1695678735059ULL, 1849150772699ULL,
+                2016513216611ULL, 2199023255579ULL, 2398051864517ULL, 2615094101561ULL,
+                2851780339439ULL, 3109888512037ULL, 3391357470041ULL, 3698301545321ULL,
+                4033026432887ULL, 4398046511119ULL, 4796103729013ULL, 5230188203153ULL,
+                5703560678813ULL, 6219777023959ULL, 6782714940109ULL, 7396603090651ULL,
+                8066052865777ULL, 8796093022237ULL, 9592207458013ULL, 10460376406273ULL,
+                11407121357629ULL, 12439554047911ULL, 13565429880173ULL, 14793206181251ULL,
+                16132105731557ULL, 17592186044423ULL, 19184414915957ULL, 20920752812489ULL,
+                22814242715249ULL, 24879108095833ULL, 27130859760293ULL, 29586412362491ULL,
+                32264211463207ULL, 35184372088891ULL, 38368829831873ULL, 41841505624973ULL,
+                45628485430361ULL, 49758216191633ULL, 54261719520731ULL, 59172824724919ULL,
+                64528422926167ULL, 70368744177679ULL, 76737659663747ULL, 83683011249917ULL,
+                91256970860717ULL, 99516432383281ULL, 108523439041163ULL, 118345649449813ULL,
+                129056845852313ULL, 140737488355333ULL, 153475319327443ULL, 167366022499847ULL,
+                182513941721429ULL, 199032864766447ULL, 217046878082327ULL, 236691298899683ULL,
+                258113691704623ULL, 281474976710677ULL, 306950638654769ULL, 334732044999557ULL,
+                365027883442853ULL, 398065729532981ULL, 434093756164631ULL, 473382597799229ULL,
+                516227383409233ULL, 562949953421381ULL, 613901277309491ULL, 669464089999087ULL,
+                730055766885707ULL, 796131459065743ULL, 868187512329281ULL, 946765195598473ULL,
+                1032454766818511ULL, 1125899906842679ULL, 1227802554619019ULL, 1338928179998197ULL,
+                1460111533771417ULL, 1592262918131449ULL, 1736375024658541ULL, 1893530391196921ULL,
+                2064909533636903ULL, 2251799813685269ULL, 2455605109237993ULL, 2677856359996339ULL,
+                2920223067542839ULL, 3184525836262943ULL, 3472750049317067ULL, 3787060782393821ULL,
+                4129819067273813ULL, 4503599627370517ULL, 4911210218475917ULL, 5355712719992603ULL,
+                5840446135085641ULL, 6369051672525833ULL, 6945500098633949ULL, 7574121564787633ULL,
+                8259638134547647ULL, 9007199254740997ULL, 9822420436951807ULL,
+                10711425439985201ULL, 11680892270171227ULL, 12738103345051607ULL,
+                13891000197267901ULL, 15148243129575289ULL, 16519276269095183ULL,
+                18014398509482143ULL, 19644840873903613ULL, 21422850879970409ULL,
+                23361784540342439ULL, 25476206690103097ULL, 27782000394535819ULL,
+                30296486259150569ULL, 33038552538190489ULL, 36028797018963971ULL,
+                39289681747807201ULL, 42845701759940789ULL, 46723569080684917ULL,
+                50952413380206277ULL, 55564000789071631ULL, 60592972518301033ULL,
+                66077105076380809ULL, 72057594037928017ULL, 78579363495614417ULL,
+                85691403519881611ULL, 93447138161369717ULL, 101904826760412407ULL,
+                111128001578143153ULL, 121185945036602129ULL, 132154210152761509ULL,
+                144115188075855881ULL, 157158726991228771ULL, 171382807039763141ULL,
+                186894276322739443ULL, 203809653520824899ULL, 222256003156286383ULL,
+                242371890073204189ULL, 264308420305522981ULL, 288230376151711813ULL,
+                314317453982457589ULL, 342765614079526259ULL, 373788552645478849ULL,
+                407619307041649517ULL, 444512006312572733ULL, 484743780146408269ULL,
+                528616840611045827ULL, 576460752303423619ULL, 628634907964915091ULL,
+                685531228159052423ULL, 747577105290957769ULL, 815238614083298983ULL,
+                889024012625145233ULL, 969487560292816531ULL, 1057233681222091651ULL,
+                1152921504606847009ULL, 1257269815929830159ULL, 1371062456318104843ULL,
+                1495154210581915423ULL, 1630477228166598073ULL, 1778048025250290463ULL,
+                1938975120585633047ULL, 2114467362444183311ULL, 2305843009213693967ULL,
+                2514539631859660319ULL, 2742124912636209673ULL, 2990308421163830887ULL,
+                3260954456333195779ULL, 3556096050500580869ULL, 3877950241171266059ULL,
+                4228934724888366613ULL, 4611686018427388039ULL, 5029079263719320651ULL,
+                5484249825272419379ULL, 5980616842327661587ULL, 6521908912666391591ULL,
+                7112192101001161747ULL, 7755900482342532131ULL, 8457869449776733187ULL,
+                9223372036854775837ULL, 10058158527438641153ULL, 10968499650544838657ULL,
+                11961233684655323309ULL, 13043817825332783143ULL, 14224384202002323617ULL,
+                15511800964685064227ULL, 16915738899553466383ULL, 18446744073709551557ULL
+            };
+            const uint64_t* __e = __primes + sizeof(__primes) / sizeof(__primes[0]);
+            const uint64_t* __p = _VSTD::lower_bound(__primes, __e, static_cast<uint64_t>(__n));
+            if (__p == __e || *__p > numeric_limits<size_t>::max())
+                __throw_overflow_error("__next_prime overflow");
+            return static_cast<size_t>(*__p);
+        }
+
+        inline _LIBCPP_INLINE_VISIBILITY
+        size_t
+        __next_hash_pow2(size_t __n)
+        {
+            return (__n > 1) ? (size_t(1) << (std::numeric_limits<size_t>::digits - __clz(__n-1))) : __n;
+        }
+
+
+        // Sets of at least __parallel_threshold_ nodes are shuffled on
+        // __threads_ threads (0 means thread::hardware_concurrency()). One
+        // thread by default: begin() must not start threads behind a caller
+        // that has not asked for them. With __in_place_ set, serial shuffles
+        // skip the O(n) node index and merge-shuffle the chain instead, which
+        // allocates nothing but takes O(n log n) time.
+        struct __hash_shuffle_options
+        {
+            size_t   __parallel_threshold_;
+            unsigned __threads_;
+            bool     __in_place_;
+
+            _LIBCPP_INLINE_VISIBILITY
+            __hash_shuffle_options() _NOEXCEPT
+                    : __parallel_threshold_(size_t(1) << 22),
+                      __threads_(1),
+                      __in_place_(false)
+            {}
+        };
+
+        // PCG32 (XSH-RR): 16 bytes of state, no locks, no allocation. Every
+        // shuffling table owns one, so shuffles on different threads never contend the
+        // way they did on rand(). A default-constructed engine picks its stream
+        // from its own address, so two tables draw different sequences.
+        class __hash_rng
+        {
+            uint64_t __state_;
+            uint64_t __inc_;
+
+        public:
+            typedef uint32_t result_type;
+
+            _LIBCPP_INLINE_VISIBILITY
+            __hash_rng() _NOEXCEPT
+            {seed(0x853c49e6748fea9bULL, reinterpret_cast<uintptr_t>(this));}
+            _LIBCPP_INLINE_VISIBILITY
+            explicit __hash_rng(uint64_t __s, uint64_t __stream = 0xda3e39cb94b95bdbULL) _NOEXCEPT
+            {seed(__s, __stream);}
+
+            _LIBCPP_INLINE_VISIBILITY
+            void seed(uint64_t __s, uint64_t __stream = 0xda3e39cb94b95bdbULL) _NOEXCEPT
+            {
+                __state_ = 0;
+                __inc_ = (__stream << 1) | 1;
+                (*this)();
+                __state_ += __s;
+                (*this)();
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            static _LIBCPP_CONSTEXPR result_type min() {return 0;}
+            _LIBCPP_INLINE_VISIBILITY
+            static _LIBCPP_CONSTEXPR result_type max() {return 0xFFFFFFFFu;}
+
+            _LIBCPP_INLINE_VISIBILITY
+            result_type operator()() _NOEXCEPT
+            {
+                uint64_t __old = __state_;
+                __state_ = __old * 6364136223846793005ULL + __inc_;
+                uint32_t __xs = static_cast<uint32_t>(((__old >> 18) ^ __old) >> 27);
+                uint32_t __rot = static_cast<uint32_t>(__old >> 59);
+                return (__xs >> __rot) | (__xs << ((0u - __rot) & 31));
+            }
+
+            // Uniform in [0, __n), __n > 0, by Lemire's multiply-shift: the high
+            // half of a 32x32 product, with the rare biased low values redrawn.
+            _LIBCPP_INLINE_VISIBILITY
+            uint32_t __bounded(uint32_t __n) _NOEXCEPT
+            {
+                uint64_t __m = static_cast<uint64_t>((*this)()) * __n;
+                uint32_t __l = static_cast<uint32_t>(__m);
+                if (__l < __n)
+                {
+                    uint32_t __t = (0u - __n) % __n;
+                    while (__l < __t)
+                    {
+                        __m = static_cast<uint64_t>((*this)()) * __n;
+                        __l = static_cast<uint32_t>(__m);
+                    }
+                }
+                return static_cast<uint32_t>(__m >> 32);
+            }
+        };
+
+        // Uniform in [0, __n) from any generator; __hash_rng, and anything
+        // derived from it such as __hash_seeded_rng, gets the cheap reduction
+        // whenever __n fits its 32 bits.
+        template <class _URBG>
+        inline _LIBCPP_INLINE_VISIBILITY
+        typename enable_if<!is_base_of<__hash_rng, _URBG>::value, size_t>::type
+        __hash_uniform(_URBG& __g, size_t __n)
+        {
+            return uniform_int_distribution<size_t>(0, __n - 1)(__g);
+        }
+
+        inline _LIBCPP_INLINE_VISIBILITY
+        size_t __hash_uniform(__hash_rng& __g, size_t __n) _NOEXCEPT
+        {
+            if (__n <= 0xFFFFFFFFu)
+                return __g.__bounded(static_cast<uint32_t>(__n));
+            return uniform_int_distribution<size_t>(0, __n - 1)(__g);
+        }
+
+        // __hash_rng that starts from _Seed wherever it lives.
+        template <unsigned long long _Seed>
+        class __hash_seeded_rng
+                : public __hash_rng
+        {
+        public:
+            _LIBCPP_INLINE_VISIBILITY
+            __hash_seeded_rng() _NOEXCEPT : __hash_rng(_Seed) {}
+        };
+
+        // Iteration-order policies for unordered_set. ordered_iteration is plain
+        // libc++ hash order. randomized_iteration reshuffles from the table's
+        // own generator when begin() is called on a set that changed since its
+        // last shuffle. seeded_iteration<_Seed> does the same, but the table's
+        // generator starts from _Seed rather than from its address, so a given
+        // sequence of operations always yields the same orders.
+        //
+        // Only a non-const begin() shuffles. A const begin() or cbegin()
+        // returns the order the last shuffle left, which is hash order if
+        // there was none, with elements inserted since then in their
+        // buckets' places. So under either shuffling policy the const order
+        // is the shuffled (for seeded_iteration, the seeded) one only while
+        // the set is unmodified since a non-const begin(). Under
+        // seeded_iteration it is reproducible all the same.
+        struct _LIBCPP_TEMPLATE_VIS ordered_iteration {};
+        struct _LIBCPP_TEMPLATE_VIS randomized_iteration {};
+        template <unsigned long long _Seed> struct _LIBCPP_TEMPLATE_VIS seeded_iteration {};
+
+        template <class _Order> struct __hash_iteration_traits;
+
+        template <>
+        struct __hash_iteration_traits<ordered_iteration>
+        {
+            typedef false_type __shuffles;
+        };
+
+        template <>
+        struct __hash_iteration_traits<randomized_iteration>
+        {
+            typedef true_type  __shuffles;
+            typedef __hash_rng __rng;
+        };
+
+        template <unsigned long long _Seed>
+        struct __hash_iteration_traits<seeded_iteration<_Seed> >
+        {
+            typedef true_type  __shuffles;
+            typedef __hash_seeded_rng<_Seed> __rng;
+        };
+
+        // What a table with a shuffling _Order keeps besides its nodes: the
+        // generator begin() and reshuffle() draw from, the shuffle options, a
+        // version count that tells begin_random() whether the last shuffle
+        // still stands, and the samplers' bound on the longest bucket, exact
+        // after a recount and raised on insertion. Erasure leaves the bound
+        // alone until size() drops below half of __bound_recount_size_, the
+        // size at the last recount, when the samplers' expected draws per
+        // element, bucket_count() * bound / size(), have at least doubled.
+        //
+        // __hash_table derives from it, and under ordered_iteration it is
+        // empty, so such a table keeps libc++'s layout and insertion cost. It
+        // has no generator of its own, so reshuffle() and seed() are not
+        // available, and begin_random(g) shuffles with the default options.
+        template <class _Order, bool = __hash_iteration_traits<_Order>::__shuffles::value>
+        class __hash_order_state
+        {
+            typedef typename __hash_iteration_traits<_Order>::__rng __rng_type;
+
+            size_t __version_;
+            size_t __shuffled_version_;
+            size_t __bucket_size_bound_;
+            size_t __bound_recount_size_;
+            // It has state, so unlike the table's functors there is nothing
+            // for __compressed_pair to fold away.
+            __rng_type             __rng_;
+            __hash_shuffle_options __shuffle_options_;
+
+        protected:
+            _LIBCPP_INLINE_VISIBILITY
+            __hash_order_state() _NOEXCEPT
+                    : __version_(0),
+                      __shuffled_version_(size_t(-1)),
+                      __bucket_size_bound_(0),
+                      __bound_recount_size_(0)
+            {}
+
+            _LIBCPP_INLINE_VISIBILITY
+            __rng_type& __rng() _NOEXCEPT {return __rng_;}
+            _LIBCPP_INLINE_VISIBILITY
+            __hash_shuffle_options& __shuffle_options() _NOEXCEPT {return __shuffle_options_;}
+            _LIBCPP_INLINE_VISIBILITY
+            const __hash_shuffle_options& __shuffle_options() const _NOEXCEPT {return __shuffle_options_;}
+
+            _LIBCPP_INLINE_VISIBILITY
+            void __note_change() _NOEXCEPT {++__version_;}
+            _LIBCPP_INLINE_VISIBILITY
+            bool __shuffle_stands() const _NOEXCEPT {return __shuffled_version_ == __version_;}
+            _LIBCPP_INLINE_VISIBILITY
+            void __note_shuffle() _NOEXCEPT {__shuffled_version_ = __version_;}
+
+            _LIBCPP_INLINE_VISIBILITY
+            size_t __bucket_size_bound() const _NOEXCEPT {return __bucket_size_bound_;}
+            _LIBCPP_INLINE_VISIBILITY
+            void __raise_bucket_size_bound(size_t __s) _NOEXCEPT
+            {
+                if (__s > __bucket_size_bound_)
+                    __bucket_size_bound_ = __s;
+            }
+            _LIBCPP_INLINE_VISIBILITY
+            void __set_bucket_size_bound(size_t __b, size_t __size) _NOEXCEPT
+            {
+                __bucket_size_bound_ = __b;
+                __bound_recount_size_ = __size;
+            }
+            _LIBCPP_INLINE_VISIBILITY
+            bool __bucket_size_bound_stale(size_t __size) const _NOEXCEPT
+            {return __size < __bound_recount_size_ / 2;}
+
+            // The nodes went to another table or away: the bound goes, and so
+            // does the last shuffle.
+            _LIBCPP_INLINE_VISIBILITY
+            void __drop_nodes() _NOEXCEPT
+            {
+                __set_bucket_size_bound(0, 0);
+                __note_change();
+            }
+            // This table takes over __u's nodes, as they were.
+            _LIBCPP_INLINE_VISIBILITY
+            void __take_nodes(__hash_order_state& __u) _NOEXCEPT
+            {
+                __set_bucket_size_bound(__u.__bucket_size_bound_, __u.__bound_recount_size_);
+                __u.__drop_nodes();
+            }
+            _LIBCPP_INLINE_VISIBILITY
+            void __take_order(__hash_order_state& __u) _NOEXCEPT
+            {
+                __version_ = __u.__version_;
+                __shuffled_version_ = __u.__shuffled_version_;
+                __take_nodes(__u);
+            }
+            _LIBCPP_INLINE_VISIBILITY
+            void __swap_state(__hash_order_state& __u) _NOEXCEPT
+            {
+                _VSTD::swap(__version_, __u.__version_);
+                _VSTD::swap(__shuffled_version_, __u.__shuffled_version_);
+                _VSTD::swap(__bucket_size_bound_, __u.__bucket_size_bound_);
+                _VSTD::swap(__bound_recount_size_, __u.__bound_recount_size_);
+                _VSTD::swap(__shuffle_options_, __u.__shuffle_options_);
+            }
+        };
+
+        template <class _Order>
+        class __hash_order_state<_Order, false>
+        {
+        protected:
+            _LIBCPP_INLINE_VISIBILITY
+            __hash_shuffle_options __shuffle_options() const _NOEXCEPT {return __hash_shuffle_options();}
+
+            _LIBCPP_INLINE_VISIBILITY
+            void __note_change() _NOEXCEPT {}
+            _LIBCPP_INLINE_VISIBILITY
+            bool __shuffle_stands() const _NOEXCEPT {return false;}
+            _LIBCPP_INLINE_VISIBILITY
+            void __note_shuffle() _NOEXCEPT {}
+            _LIBCPP_INLINE_VISIBILITY
+            bool __bucket_size_bound_stale(size_t) const _NOEXCEPT {return false;}
+            _LIBCPP_INLINE_VISIBILITY
+            void __drop_nodes() _NOEXCEPT {}
+            _LIBCPP_INLINE_VISIBILITY
+            void __take_nodes(__hash_order_state&) _NOEXCEPT {}
+            _LIBCPP_INLINE_VISIBILITY
+            void __take_order(__hash_order_state&) _NOEXCEPT {}
+            _LIBCPP_INLINE_VISIBILITY
+            void __swap_state(__hash_order_state&) _NOEXCEPT {}
+        };
+
+        // The settings of the optional bucket-array machinery that
+        // hash_bucket_features compiled in; each is an empty base, reading
+        // as off, when its feature is not.
+        template <bool _Enabled>
+        class __hash_fingerprint_option
+        {
+            bool __fingerprinted_;
+
+        public:
+            _LIBCPP_INLINE_VISIBILITY
+            __hash_fingerprint_option() _NOEXCEPT : __fingerprinted_(false) {}
+
+            _LIBCPP_INLINE_VISIBILITY
+            bool __fingerprinted() const _NOEXCEPT {return __fingerprinted_;}
+            _LIBCPP_INLINE_VISIBILITY
+            void __set_fingerprinted(bool __on) _NOEXCEPT {__fingerprinted_ = __on;}
+        };
+
+        template <>
+        class __hash_fingerprint_option<false>
+        {
+        public:
+            _LIBCPP_INLINE_VISIBILITY
+            bool __fingerprinted() const _NOEXCEPT {return false;}
+            _LIBCPP_INLINE_VISIBILITY
+            void __set_fingerprinted(bool) _NOEXCEPT {}
+        };
+
+        template <bool _Enabled>
+        class __hash_huge_page_option
+        {
+            size_t __huge_page_threshold_;
+
+        public:
+            _LIBCPP_INLINE_VISIBILITY
+            __hash_huge_page_option() _NOEXCEPT : __huge_page_threshold_(0) {}
+
+            _LIBCPP_INLINE_VISIBILITY
+            size_t __huge_page_threshold() const _NOEXCEPT {return __huge_page_threshold_;}
+            _LIBCPP_INLINE_VISIBILITY
+            void __set_huge_page_threshold(size_t __n) _NOEXCEPT {__huge_page_threshold_ = __n;}
+        };
+
+        template <>
+        class __hash_huge_page_option<false>
+        {
+        public:
+            _LIBCPP_INLINE_VISIBILITY
+            size_t __huge_page_threshold() const _NOEXCEPT {return 0;}
+            _LIBCPP_INLINE_VISIBILITY
+            void __set_huge_page_threshold(size_t) _NOEXCEPT {}
+        };
+
+        template <bool _Enabled>
+        class __hash_pow2_option
+        {
+            bool __pow2_mixing_;
+
+        public:
+            _LIBCPP_INLINE_VISIBILITY
+            __hash_pow2_option() _NOEXCEPT : __pow2_mixing_(false) {}
+
+            _LIBCPP_INLINE_VISIBILITY
+            bool __pow2_mixing() const _NOEXCEPT {return __pow2_mixing_;}
+            _LIBCPP_INLINE_VISIBILITY
+            void __set_pow2_mixing(bool __on) _NOEXCEPT {__pow2_mixing_ = __on;}
+        };
+
+        template <>
+        class __hash_pow2_option<false>
+        {
+        public:
+            _LIBCPP_INLINE_VISIBILITY
+            bool __pow2_mixing() const _NOEXCEPT {return false;}
+            _LIBCPP_INLINE_VISIBILITY
+            void __set_pow2_mixing(bool) _NOEXCEPT {}
+        };
+
+        template <class _Features>
+        class __hash_bucket_options
+                : public __hash_fingerprint_option<_Features::fingerprints::value>,
+                  public __hash_huge_page_option<_Features::huge_pages::value>,
+                  public __hash_pow2_option<_Features::pow2_mixing::value>
+        {
+        };
+
+        template <class _Tp> struct __is_hash_node : false_type {};
+        template <class _Tp, class _VoidPtr, bool _CacheHash>
+        struct __is_hash_node<__hash_node<_Tp, _VoidPtr, _CacheHash> > : true_type {};
+
+        // Fixed-size node storage for hash_slab_allocator. Slots are carved
+        // from chunks that double in size up to __max_chunk_bytes, freed slots
+        // go on an intrusive LIFO list, and chunks are only returned to
+        // operator delete by __release() once no slot is live, or when the
+        // last allocator referring to the pool goes away. Not thread-safe:
+        // copies of one allocator must not be used concurrently.
+        class __hash_slab_pool
+        {
+            struct __chunk
+            {
+                __chunk* __next_;
+            };
+
+            enum
+            {
+                __min_chunk_slots = 32,
+                __max_chunk_bytes = 64 * 1024
+            };
+
+            void*    __free_;
+            char*    __bump_;
+            char*    __bump_end_;
+            __chunk* __chunks_;
+            size_t   __slot_size_;
+            size_t   __chunk_slots_;
+            size_t   __live_;
+            size_t   __refs_;
+
+            _LIBCPP_INLINE_VISIBILITY
+            static size_t __header_size() _NOEXCEPT
+            {
+                const size_t __a = alignof(max_align_t);
+                return (sizeof(__chunk) + __a - 1) / __a * __a;
+            }
+
+            void __grow()
+            {
+                size_t __bytes = __header_size() + __chunk_slots_ * __slot_size_;
+                __chunk* __c = static_cast<__chunk*>(::operator new(__bytes));
+                __c->__next_ = __chunks_;
+                __chunks_ = __c;
+                __bump_ = reinterpret_cast<char*>(__c) + __header_size();
+                __bump_end_ = reinterpret_cast<char*>(__c) + __bytes;
+                if (__chunk_slots_ * __slot_size_ * 2 <= __max_chunk_bytes)
+                    __chunk_slots_ *= 2;
+            }
+
+        public:
+            _LIBCPP_INLINE_VISIBILITY
+            __hash_slab_pool() _NOEXCEPT
+                    : __free_(nullptr),
+                      __bump_(nullptr),
+                      __bump_end_(nullptr),
+                      __chunks_(nullptr),
+                      __slot_size_(0),
+                      __chunk_slots_(__min_chunk_slots),
+                      __live_(0),
+                      __refs_(1)
+            {}
+
+            _LIBCPP_INLINE_VISIBILITY
+            ~__hash_slab_pool() {__free_chunks();}
+
+            // The slot size, 0 until the first __serves().
+            _LIBCPP_INLINE_VISIBILITY
+            size_t __slot_size() const _NOEXCEPT {return __slot_size_;}
+            // Whether slots of __slot_size bytes come from this pool: the
+            // first size asked about is the only one it hands out. It must be
+            // a multiple of the node's alignment, which is at most
+            // alignof(max_align_t).
+            _LIBCPP_INLINE_VISIBILITY
+            bool __serves(size_t __slot_size) _NOEXCEPT
+            {
+                if (__slot_size_ == 0)
+                    __slot_size_ = __slot_size;
+                return __slot_size_ == __slot_size;
+            }
+            _LIBCPP_INLINE_VISIBILITY
+            void __retain() _NOEXCEPT {++__refs_;}
+            _LIBCPP_INLINE_VISIBILITY
+            bool __unref() _NOEXCEPT {return --__refs_ == 0;}
+
+            _LIBCPP_INLINE_VISIBILITY
+            void* __allocate()
+            {
+                void* __p = __free_;
+                if (__p != nullptr)
+                    __free_ = *static_cast<void**>(__p);
+                else
+                {
+                    if (__bump_ == __bump_end_)
+                        __grow();
+                    __p = __bump_;
+                    __bump_ += __slot_size_;
+                }
+                ++__live_;
+                return __p;
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            void __deallocate(void* __p) _NOEXCEPT
+            {
+                *static_cast<void**>(__p) = __free_;
+                __free_ = __p;
+                --__live_;
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            void __release() _NOEXCEPT
+            {
+                if (__live_ == 0)
+                    __free_chunks();
+            }
+
+        private:
+            void __free_chunks() _NOEXCEPT
+            {
+                while (__chunks_ != nullptr)
+                {
+                    __chunk* __next = __chunks_->__next_;
+                    ::operator delete(__chunks_);
+                    __chunks_ = __next;
+                }
+                __free_ = nullptr;
+                __bump_ = __bump_end_ = nullptr;
+                __chunk_slots_ = __min_chunk_slots;
+            }
+        };
+
+        // Allocator for node-based unordered containers:
+        //
+        //     unordered_set<T, H, E, hash_slab_allocator<T> >
+        //
+        // Single-node requests for the table's __hash_node type are served
+        // from a __hash_slab_pool shared by all copies and rebinds of one
+        // allocator; everything else, such as the bucket array, goes straight
+        // to operator new. The pool is created with the allocator, so copies
+        // made before anything is allocated still share it and compare equal,
+        // and it takes its slot size from the first node allocated. A
+        // container copy gets a fresh pool, moves and swaps carry the pool
+        // along, and __hash_table hands empty chunks back from clear() and its
+        // destructor through __release_node_storage().
+        template <class _Tp>
+        class _LIBCPP_TEMPLATE_VIS hash_slab_allocator
+        {
+            __hash_slab_pool* __pool_;
+
+            template <class> friend class _LIBCPP_TEMPLATE_VIS hash_slab_allocator;
+
+            _LIBCPP_INLINE_VISIBILITY
+            static size_t __slot_size() _NOEXCEPT
+            {
+                size_t __s = sizeof(_Tp) < sizeof(void*) ? sizeof(void*) : sizeof(_Tp);
+                return (__s + alignof(_Tp) - 1) / alignof(_Tp) * alignof(_Tp);
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            static _LIBCPP_CONSTEXPR bool __pooled_type() _NOEXCEPT
+            {
+                return __is_hash_node<_Tp>::value &&
+                       alignof(_Tp) <= alignof(max_align_t) &&
+                       alignof(_Tp) >= alignof(void*);
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            bool __from_pool(size_t __n) const _NOEXCEPT
+            {
+                return __pooled_type() && __n == 1 && __pool_->__slot_size() == __slot_size();
+            }
+
+        public:
+            typedef _Tp       value_type;
+            typedef size_t    size_type;
+            typedef ptrdiff_t difference_type;
+
+            typedef true_type  propagate_on_container_move_assignment;
+            typedef true_type  propagate_on_container_swap;
+            typedef false_type propagate_on_container_copy_assignment;
+
+            template <class _Up> struct rebind {typedef hash_slab_allocator<_Up> other;};
+
+            _LIBCPP_INLINE_VISIBILITY
+            hash_slab_allocator() : __pool_(new __hash_slab_pool()) {}
+            _LIBCPP_INLINE_VISIBILITY
+            hash_slab_allocator(const hash_slab_allocator& __a) _NOEXCEPT
+                    : __pool_(__a.__pool_)
+            {
+                __pool_->__retain();
+            }
+            template <class _Up>
+            _LIBCPP_INLINE_VISIBILITY
+            hash_slab_allocator(const hash_slab_allocator<_Up>& __a) _NOEXCEPT
+                    : __pool_(__a.__pool_)
+            {
+                __pool_->__retain();
+            }
+            _LIBCPP_INLINE_VISIBILITY
+            ~hash_slab_allocator()
+            {
+                if (__pool_->__unref())
+                    delete __pool_;
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            hash_slab_allocator& operator=(const hash_slab_allocator& __a) _NOEXCEPT
+            {
+                hash_slab_allocator(__a).swap(*this);
+                return *this;
             }
 
             _LIBCPP_INLINE_VISIBILITY
-            __node_pointer __upcast() _NOEXCEPT {
-                return static_cast<__node_pointer>(
-                        pointer_traits<__node_base_pointer>::pointer_to(*this));
+            void swap(hash_slab_allocator& __a) _NOEXCEPT
+            {
+                __hash_slab_pool* __t = __pool_;
+                __pool_ = __a.__pool_;
+                __a.__pool_ = __t;
             }
 
             _LIBCPP_INLINE_VISIBILITY
-            size_t __hash() const _NOEXCEPT {
-                return static_cast<__node_type const&>(*this).__hash_;
+            hash_slab_allocator select_on_container_copy_construction() const
+            {return hash_slab_allocator();}
+
+            _LIBCPP_INLINE_VISIBILITY
+            size_type max_size() const _NOEXCEPT {return size_type(~0) / sizeof(_Tp);}
+
+            _Tp* allocate(size_type __n)
+            {
+                if (__pooled_type() && __n == 1 && __pool_->__serves(__slot_size()))
+                    return static_cast<_Tp*>(__pool_->__allocate());
+                if (__n > max_size())
+                    __throw_length_error("hash_slab_allocator<T>::allocate(size_t n)"
+                                         " 'n' exceeds maximum supported size");
+                return static_cast<_Tp*>(::operator new(__n * sizeof(_Tp)));
             }
 
-            _LIBCPP_INLINE_VISIBILITY __hash_node_base() _NOEXCEPT : __next_(nullptr) {}
-        };
+            _LIBCPP_INLINE_VISIBILITY
+            void deallocate(_Tp* __p, size_type __n) _NOEXCEPT
+            {
+                if (__from_pool(__n))
+                    __pool_->__deallocate(__p);
+                else
+                    ::operator delete(__p);
+            }
 
-        template <class _Tp, class _VoidPtr>
-        struct __hash_node
-                : public __hash_node_base
-                        <
-                                typename __rebind_pointer<_VoidPtr, __hash_node<_Tp, _VoidPtr> >::type
-                        >
-        {
-            typedef _Tp __node_value_type;
+            // Returns the pool's chunks to the system if none of its slots
+            // are in use.
+            _LIBCPP_INLINE_VISIBILITY
+            void release() _NOEXCEPT {__pool_->__release();}
 
-            size_t            __hash_;
-            __node_value_type __value_;
+            template <class _Up>
+            _LIBCPP_INLINE_VISIBILITY
+            bool operator==(const hash_slab_allocator<_Up>& __a) const _NOEXCEPT
+            {return __pool_ == __a.__pool_;}
+            template <class _Up>
+            _LIBCPP_INLINE_VISIBILITY
+            bool operator!=(const hash_slab_allocator<_Up>& __a) const _NOEXCEPT
+            {return __pool_ != __a.__pool_;}
         };
 
+        template <class _Alloc>
         inline _LIBCPP_INLINE_VISIBILITY
-        bool
-        __is_hash_power2(size_t __bc)
-        {
-            return __bc > 2 && !(__bc & (__bc - 1));
-        }
-
-        inline _LIBCPP_INLINE_VISIBILITY
-        size_t
-        __constrain_hash(size_t __h, size_t __bc)
-        {
-            return !(__bc & (__bc - 1)) ? __h & (__bc - 1) :
-                   (__h < __bc ? __h : __h % __bc);
-        }
+        void __release_node_storage(_Alloc&) _NOEXCEPT {}
 
+        template <class _Tp>
         inline _LIBCPP_INLINE_VISIBILITY
-        size_t
-        __next_hash_pow2(size_t __n)
+        void __release_node_storage(hash_slab_allocator<_Tp>& __a) _NOEXCEPT
         {
-            return (__n > 1) ? (size_t(1) << (std::numeric_limits<size_t>::digits - __clz(__n-1))) : __n;
+            __a.release();
         }
 
-
-        template <class _Tp, class _Hash, class _Equal, class _Alloc> class __hash_table;
+        template <class _Tp, class _Hash, class _Equal, class _Alloc,
+                  class _Order = ordered_iteration> class __hash_table;
 
         template <class _NodePtr>      class _LIBCPP_TEMPLATE_VIS __hash_iterator;
         template <class _ConstNodePtr> class _LIBCPP_TEMPLATE_VIS __hash_const_iterator;
-        template <class _NodePtr>      class _LIBCPP_TEMPLATE_VIS __hash_local_iterator;
-        template <class _ConstNodePtr> class _LIBCPP_TEMPLATE_VIS __hash_const_local_iterator;
+        template <class _NodePtr, class _Hash = void, class _Reciprocal = __hash_reciprocal<> >
+            class _LIBCPP_TEMPLATE_VIS __hash_local_iterator;
+        template <class _ConstNodePtr, class _Hash = void, class _Reciprocal = __hash_reciprocal<> >
+            class _LIBCPP_TEMPLATE_VIS __hash_const_local_iterator;
+        template <class _NodePtr, class _Hash = void, class _Reciprocal = __hash_reciprocal<> >
+            class _LIBCPP_TEMPLATE_VIS __hash_random_iterator;
+        template <class _Table, class _URBG> class _LIBCPP_TEMPLATE_VIS __hash_lazy_random_iterator;
         template <class _HashIterator> class _LIBCPP_TEMPLATE_VIS __hash_map_iterator;
         template <class _HashIterator> class _LIBCPP_TEMPLATE_VIS __hash_map_const_iterator;
 
@@ -228,8 +1168,8 @@ struct __hash_value_type;
         template <class _NodePtr, class _NodeT = typename pointer_traits<_NodePtr>::element_type>
         struct __hash_node_types;
 
-        template <class _NodePtr, class _Tp, class _VoidPtr>
-        struct __hash_node_types<_NodePtr, __hash_node<_Tp, _VoidPtr> >
+        template <class _NodePtr, class _Tp, class _VoidPtr, bool _CacheHash>
+        struct __hash_node_types<_NodePtr, __hash_node<_Tp, _VoidPtr, _CacheHash> >
                 : public __hash_key_value_types<_Tp>, __hash_map_pointer_types<_Tp, _VoidPtr>
 
         {
@@ -256,6 +1196,8 @@ struct __hash_value_type;
             typedef typename __rebind_pointer<_VoidPtr, const __node_value_type>::type
                     __const_node_value_type_pointer;
 
+            static const bool __caches_hash = _CacheHash;
+
         private:
             static_assert(!is_const<__node_type>::value,
                           "_NodePtr should never be a pointer to const");
@@ -271,15 +1213,17 @@ struct __hash_value_type;
         struct __hash_node_types_from_iterator<__hash_iterator<_NodePtr> > : __hash_node_types<_NodePtr> {};
         template <class _NodePtr>
         struct __hash_node_types_from_iterator<__hash_const_iterator<_NodePtr> > : __hash_node_types<_NodePtr> {};
-        template <class _NodePtr>
-        struct __hash_node_types_from_iterator<__hash_local_iterator<_NodePtr> > : __hash_node_types<_NodePtr> {};
-        template <class _NodePtr>
-        struct __hash_node_types_from_iterator<__hash_const_local_iterator<_NodePtr> > : __hash_node_types<_NodePtr> {};
+        template <class _NodePtr, class _Hash, class _Reciprocal>
+        struct __hash_node_types_from_iterator<__hash_local_iterator<_NodePtr, _Hash, _Reciprocal> >
+                : __hash_node_types<_NodePtr> {};
+        template <class _NodePtr, class _Hash, class _Reciprocal>
+        struct __hash_node_types_from_iterator<__hash_const_local_iterator<_NodePtr, _Hash, _Reciprocal> >
+                : __hash_node_types<_NodePtr> {};
 
 
-        template <class _NodeValueTp, class _VoidPtr>
+        template <class _NodeValueTp, class _VoidPtr, bool _CacheHash = true>
         struct __make_hash_node_types {
-            typedef __hash_node<_NodeValueTp, _VoidPtr> _NodeTp;
+            typedef __hash_node<_NodeValueTp, _VoidPtr, _CacheHash> _NodeTp;
             typedef typename __rebind_pointer<_VoidPtr, _NodeTp>::type _NodePtr;
             typedef __hash_node_types<_NodePtr> type;
         };
@@ -370,18 +1314,6 @@ struct __hash_value_type;
             {return !(__x == __y);}
 
 
-            // START ADDED CODE
-            _LIBCPP_INLINE_VISIBILITY
-            __next_pointer getNode() {
-                return __node_;
-            }
-            _LIBCPP_INLINE_VISIBILITY
-            void setNext(__hash_iterator next_it) {
-                __node_->__next_ = next_it.getNode();
-            }
-            // END CODE
-
-
         private:
 #if _LIBCPP_DEBUG_LEVEL >= 2
             _LIBCPP_INLINE_VISIBILITY
@@ -396,7 +1328,7 @@ struct __hash_value_type;
                     : __node_(__node)
             {}
 #endif
-            template <class, class, class, class> friend class __hash_table;
+            template <class, class, class, class, class> friend class __hash_table;
             template <class> friend class _LIBCPP_TEMPLATE_VIS __hash_const_iterator;
             template <class> friend class _LIBCPP_TEMPLATE_VIS __hash_map_iterator;
             template <class, class, class, class, class> friend class _LIBCPP_TEMPLATE_VIS unordered_map;
@@ -512,16 +1444,67 @@ struct __hash_value_type;
                     : __node_(__node)
             {}
 #endif
-            template <class, class, class, class> friend class __hash_table;
+            template <class, class, class, class, class> friend class __hash_table;
             template <class> friend class _LIBCPP_TEMPLATE_VIS __hash_map_const_iterator;
             template <class, class, class, class, class> friend class _LIBCPP_TEMPLATE_VIS unordered_map;
             template <class, class, class, class, class> friend class _LIBCPP_TEMPLATE_VIS unordered_multimap;
         };
 
-        template <class _NodePtr>
+        // Where an iterator that has to detect the end of a bucket gets a
+        // node's hash from: the node itself when it caches one (_Hash is void),
+        // otherwise a copy of the table's hasher. The copy keeps the iterator
+        // valid across a swap or move of the table, and is empty for the usual
+        // stateless hashers, so neither case makes those iterators bigger.
+        template <class _NextPtr, class _Hash,
+                  bool = is_empty<_Hash>::value && !__libcpp_is_final<_Hash>::value>
+        class __hash_node_hash_source
+                : private _Hash
+        {
+        public:
+            _LIBCPP_INLINE_VISIBILITY __hash_node_hash_source() _NOEXCEPT {}
+            _LIBCPP_INLINE_VISIBILITY
+            explicit __hash_node_hash_source(const _Hash& __h) _NOEXCEPT : _Hash(__h) {}
+
+            _LIBCPP_INLINE_VISIBILITY
+            size_t __node_hash(_NextPtr __np) const _NOEXCEPT
+            {return static_cast<const _Hash&>(*this)(__np->__upcast()->__value_);}
+        };
+
+        template <class _NextPtr, class _Hash>
+        class __hash_node_hash_source<_NextPtr, _Hash, false>
+        {
+            _Hash __hash_;
+
+        public:
+            _LIBCPP_INLINE_VISIBILITY __hash_node_hash_source() _NOEXCEPT : __hash_() {}
+            _LIBCPP_INLINE_VISIBILITY
+            explicit __hash_node_hash_source(const _Hash& __h) _NOEXCEPT : __hash_(__h) {}
+
+            _LIBCPP_INLINE_VISIBILITY
+            size_t __node_hash(_NextPtr __np) const _NOEXCEPT
+            {return __hash_(__np->__upcast()->__value_);}
+        };
+
+        template <class _NextPtr>
+        class __hash_node_hash_source<_NextPtr, void, false>
+        {
+        public:
+            _LIBCPP_INLINE_VISIBILITY __hash_node_hash_source() _NOEXCEPT {}
+            template <class _Hp>
+            _LIBCPP_INLINE_VISIBILITY
+            explicit __hash_node_hash_source(const _Hp&) _NOEXCEPT {}
+
+            _LIBCPP_INLINE_VISIBILITY
+            size_t __node_hash(_NextPtr __np) const _NOEXCEPT {return __np->__hash();}
+        };
+
+        template <class _NodePtr, class _Hash, class _Reciprocal>
         class _LIBCPP_TEMPLATE_VIS __hash_local_iterator
+                : private __hash_node_hash_source<typename __hash_node_types<_NodePtr>::__next_pointer, _Hash>,
+                  private _Reciprocal
         {
             typedef __hash_node_types<_NodePtr> _NodeTypes;
+            typedef __hash_node_hash_source<typename _NodeTypes::__next_pointer, _Hash> __hash_source;
             typedef _NodePtr                            __node_pointer;
             typedef typename _NodeTypes::__next_pointer __next_pointer;
 
@@ -543,7 +1526,9 @@ struct __hash_value_type;
 #if _LIBCPP_DEBUG_LEVEL >= 2
             _LIBCPP_INLINE_VISIBILITY
     __hash_local_iterator(const __hash_local_iterator& __i)
-        : __node_(__i.__node_),
+        : __hash_source(__i),
+          _Reciprocal(__i),
+          __node_(__i.__node_),
           __bucket_(__i.__bucket_),
           __bucket_count_(__i.__bucket_count_)
     {
@@ -562,9 +1547,11 @@ struct __hash_value_type;
         if (this != &__i)
         {
             __get_db()->__iterator_copy(this, &__i);
+            __hash_source::operator=(__i);
             __node_ = __i.__node_;
             __bucket_ = __i.__bucket_;
             __bucket_count_ = __i.__bucket_count_;
+            _Reciprocal::operator=(__i);
         }
         return *this;
     }
@@ -589,7 +1576,9 @@ struct __hash_value_type;
                 _LIBCPP_DEBUG_ASSERT(__get_const_db()->__dereferenceable(this),
                                      "Attempted to increment non-incrementable unordered container local_iterator");
                 __node_ = __node_->__next_;
-                if (__node_ != nullptr && __constrain_hash(__node_->__hash(), __bucket_count_) != __bucket_)
+                if (__node_ != nullptr &&
+                    __constrain_hash(this->__node_hash(__node_), __bucket_count_,
+                                     static_cast<const _Reciprocal&>(*this)) != __bucket_)
                     __node_ = nullptr;
                 return *this;
             }
@@ -615,8 +1604,11 @@ struct __hash_value_type;
 #if _LIBCPP_DEBUG_LEVEL >= 2
             _LIBCPP_INLINE_VISIBILITY
     __hash_local_iterator(__next_pointer __node, size_t __bucket,
-                          size_t __bucket_count, const void* __c) _NOEXCEPT
-        : __node_(__node),
+                          size_t __bucket_count, const _Reciprocal& __reciprocal,
+                          const __hash_source& __hs, const void* __c) _NOEXCEPT
+        : __hash_source(__hs),
+          _Reciprocal(__reciprocal),
+          __node_(__node),
           __bucket_(__bucket),
           __bucket_count_(__bucket_count)
         {
@@ -627,8 +1619,11 @@ struct __hash_value_type;
 #else
             _LIBCPP_INLINE_VISIBILITY
             __hash_local_iterator(__next_pointer __node, size_t __bucket,
-                                  size_t __bucket_count) _NOEXCEPT
-                    : __node_(__node),
+                                  size_t __bucket_count, const _Reciprocal& __reciprocal,
+                                  const __hash_source& __hs) _NOEXCEPT
+                    : __hash_source(__hs),
+                      _Reciprocal(__reciprocal),
+                      __node_(__node),
                       __bucket_(__bucket),
                       __bucket_count_(__bucket_count)
             {
@@ -636,15 +1631,18 @@ struct __hash_value_type;
                     __node_ = __node_->__next_;
             }
 #endif
-            template <class, class, class, class> friend class __hash_table;
-            template <class> friend class _LIBCPP_TEMPLATE_VIS __hash_const_local_iterator;
+            template <class, class, class, class, class> friend class __hash_table;
+            template <class, class, class> friend class _LIBCPP_TEMPLATE_VIS __hash_const_local_iterator;
             template <class> friend class _LIBCPP_TEMPLATE_VIS __hash_map_iterator;
         };
 
-        template <class _ConstNodePtr>
+        template <class _ConstNodePtr, class _Hash, class _Reciprocal>
         class _LIBCPP_TEMPLATE_VIS __hash_const_local_iterator
+                : private __hash_node_hash_source<typename __hash_node_types<_ConstNodePtr>::__next_pointer, _Hash>,
+                  private _Reciprocal
         {
             typedef __hash_node_types<_ConstNodePtr> _NodeTypes;
+            typedef __hash_node_hash_source<typename _NodeTypes::__next_pointer, _Hash> __hash_source;
             typedef _ConstNodePtr                       __node_pointer;
             typedef typename _NodeTypes::__next_pointer __next_pointer;
 
@@ -658,7 +1656,7 @@ struct __hash_value_type;
             typedef typename __rebind_pointer<__node_pointer, __non_const_node>::type
                     __non_const_node_pointer;
         public:
-            typedef __hash_local_iterator<__non_const_node_pointer>
+            typedef __hash_local_iterator<__non_const_node_pointer, _Hash, _Reciprocal>
                     __non_const_iterator;
 
             typedef forward_iterator_tag                                 iterator_category;
@@ -674,7 +1672,9 @@ struct __hash_value_type;
 
             _LIBCPP_INLINE_VISIBILITY
             __hash_const_local_iterator(const __non_const_iterator& __x) _NOEXCEPT
-                    : __node_(__x.__node_),
+                    : __hash_source(static_cast<const __hash_source&>(__x)),
+                      _Reciprocal(static_cast<const _Reciprocal&>(__x)),
+                      __node_(__x.__node_),
                       __bucket_(__x.__bucket_),
                       __bucket_count_(__x.__bucket_count_)
             {
@@ -684,7 +1684,9 @@ struct __hash_value_type;
 #if _LIBCPP_DEBUG_LEVEL >= 2
             _LIBCPP_INLINE_VISIBILITY
     __hash_const_local_iterator(const __hash_const_local_iterator& __i)
-        : __node_(__i.__node_),
+        : __hash_source(__i),
+          _Reciprocal(__i),
+          __node_(__i.__node_),
           __bucket_(__i.__bucket_),
           __bucket_count_(__i.__bucket_count_)
     {
@@ -702,91 +1704,485 @@ struct __hash_value_type;
     {
         if (this != &__i)
         {
-            __get_db()->__iterator_copy(this, &__i);
-            __node_ = __i.__node_;
-            __bucket_ = __i.__bucket_;
-            __bucket_count_ = __i.__bucket_count_;
-        }
-        return *this;
-    }
-#endif  // _LIBCPP_DEBUG_LEVEL >= 2
+            __get_db()->__iterator_copy(this, &__i);
+            __hash_source::operator=(__i);
+            __node_ = __i.__node_;
+            __bucket_ = __i.__bucket_;
+            __bucket_count_ = __i.__bucket_count_;
+            _Reciprocal::operator=(__i);
+        }
+        return *this;
+    }
+#endif  // _LIBCPP_DEBUG_LEVEL >= 2
+
+            _LIBCPP_INLINE_VISIBILITY
+            reference operator*() const {
+                _LIBCPP_DEBUG_ASSERT(__get_const_db()->__dereferenceable(this),
+                                     "Attempted to dereference a non-dereferenceable unordered container const_local_iterator");
+                return __node_->__upcast()->__value_;
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            pointer operator->() const {
+                _LIBCPP_DEBUG_ASSERT(__get_const_db()->__dereferenceable(this),
+                                     "Attempted to dereference a non-dereferenceable unordered container const_local_iterator");
+                return pointer_traits<pointer>::pointer_to(__node_->__upcast()->__value_);
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            __hash_const_local_iterator& operator++() {
+                _LIBCPP_DEBUG_ASSERT(__get_const_db()->__dereferenceable(this),
+                                     "Attempted to increment non-incrementable unordered container const_local_iterator");
+                __node_ = __node_->__next_;
+                if (__node_ != nullptr &&
+                    __constrain_hash(this->__node_hash(__node_), __bucket_count_,
+                                     static_cast<const _Reciprocal&>(*this)) != __bucket_)
+                    __node_ = nullptr;
+                return *this;
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            __hash_const_local_iterator operator++(int)
+            {
+                __hash_const_local_iterator __t(*this);
+                ++(*this);
+                return __t;
+            }
+
+            friend _LIBCPP_INLINE_VISIBILITY
+            bool operator==(const __hash_const_local_iterator& __x, const __hash_const_local_iterator& __y)
+            {
+                return __x.__node_ == __y.__node_;
+            }
+            friend _LIBCPP_INLINE_VISIBILITY
+            bool operator!=(const __hash_const_local_iterator& __x, const __hash_const_local_iterator& __y)
+            {return !(__x == __y);}
+
+        private:
+#if _LIBCPP_DEBUG_LEVEL >= 2
+            _LIBCPP_INLINE_VISIBILITY
+    __hash_const_local_iterator(__next_pointer __node, size_t __bucket,
+                                size_t __bucket_count, const _Reciprocal& __reciprocal,
+                                const __hash_source& __hs, const void* __c) _NOEXCEPT
+        : __hash_source(__hs),
+          _Reciprocal(__reciprocal),
+          __node_(__node),
+          __bucket_(__bucket),
+          __bucket_count_(__bucket_count)
+        {
+            __get_db()->__insert_ic(this, __c);
+            if (__node_ != nullptr)
+                __node_ = __node_->__next_;
+        }
+#else
+            _LIBCPP_INLINE_VISIBILITY
+            __hash_const_local_iterator(__next_pointer __node, size_t __bucket,
+                                        size_t __bucket_count, const _Reciprocal& __reciprocal,
+                                        const __hash_source& __hs) _NOEXCEPT
+                    : __hash_source(__hs),
+                      _Reciprocal(__reciprocal),
+                      __node_(__node),
+                      __bucket_(__bucket),
+                      __bucket_count_(__bucket_count)
+            {
+                if (__node_ != nullptr)
+                    __node_ = __node_->__next_;
+            }
+#endif
+            template <class, class, class, class, class> friend class __hash_table;
+            template <class> friend class _LIBCPP_TEMPLATE_VIS __hash_map_const_iterator;
+        };
+
+        // START ADDED CODE
+        // Visits the elements in a pseudo-random order without touching the node
+        // chain. Buckets are visited in the order of a keyed permutation of the
+        // next power of two >= bucket_count() (indices past the end are skipped)
+        // and each bucket's nodes in chain order, so the iterator only reads the
+        // table, keeps the locality of a bucket walk, and several of them may
+        // run over the same container at once.
+        template <class _NodePtr, class _Hash, class _Reciprocal>
+        class _LIBCPP_TEMPLATE_VIS __hash_random_iterator
+                : private __hash_node_hash_source<typename __hash_node_types<_NodePtr>::__next_pointer, _Hash>,
+                  private _Reciprocal
+        {
+            typedef __hash_node_types<_NodePtr> _NodeTypes;
+            typedef __hash_node_hash_source<typename _NodeTypes::__next_pointer, _Hash> __hash_source;
+            typedef _NodePtr                            __node_pointer;
+            typedef typename _NodeTypes::__next_pointer __next_pointer;
+            typedef typename __rebind_pointer<_NodePtr, __next_pointer>::type
+                    __next_pointer_pointer;
+
+            __next_pointer         __node_;
+            __next_pointer_pointer __buckets_;
+            size_t                 __bucket_;
+            size_t                 __bucket_count_;
+            size_t                 __mask_;
+            size_t                 __shift_;
+            size_t                 __step_;
+            size_t                 __key_[4];
+
+        public:
+            typedef forward_iterator_tag                                 iterator_category;
+            typedef typename _NodeTypes::__node_value_type               value_type;
+            typedef typename _NodeTypes::difference_type                 difference_type;
+            typedef const value_type&                                    reference;
+            typedef typename _NodeTypes::__const_node_value_type_pointer pointer;
+
+            _LIBCPP_INLINE_VISIBILITY __hash_random_iterator() _NOEXCEPT : __node_(nullptr) {}
+
+            _LIBCPP_INLINE_VISIBILITY
+            reference operator*() const {
+                return __node_->__upcast()->__value_;
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            pointer operator->() const {
+                return pointer_traits<pointer>::pointer_to(__node_->__upcast()->__value_);
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            __hash_random_iterator& operator++() {
+                __node_ = __node_->__next_;
+                if (__node_ == nullptr ||
+                    __constrain_hash(this->__node_hash(__node_), __bucket_count_,
+                                     static_cast<const _Reciprocal&>(*this)) != __bucket_)
+                    __next_bucket();
+                return *this;
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            __hash_random_iterator operator++(int)
+            {
+                __hash_random_iterator __t(*this);
+                ++(*this);
+                return __t;
+            }
+
+            friend _LIBCPP_INLINE_VISIBILITY
+            bool operator==(const __hash_random_iterator& __x, const __hash_random_iterator& __y)
+            {
+                return __x.__node_ == __y.__node_;
+            }
+            friend _LIBCPP_INLINE_VISIBILITY
+            bool operator!=(const __hash_random_iterator& __x, const __hash_random_iterator& __y)
+            {return !(__x == __y);}
+
+        private:
+            _LIBCPP_INLINE_VISIBILITY
+            __hash_random_iterator(__next_pointer_pointer __buckets, size_t __bucket_count,
+                                   const _Reciprocal& __reciprocal, const size_t (&__seed)[4],
+                                   const __hash_source& __hs) _NOEXCEPT
+                    : __hash_source(__hs),
+                      _Reciprocal(__reciprocal),
+                      __node_(nullptr),
+                      __buckets_(__buckets),
+                      __bucket_count_(__bucket_count),
+                      __mask_(__next_hash_pow2(__bucket_count) - 1),
+                      __step_(0)
+            {
+                size_t __bits = __mask_ == 0 ? 0 : numeric_limits<size_t>::digits - __clz(__mask_);
+                __shift_ = __bits / 2 + 1;
+                __key_[0] = __seed[0] & __mask_;
+                __key_[1] = (__seed[1] | 1) & __mask_;
+                __key_[2] = __seed[2] & __mask_;
+                __key_[3] = (__seed[3] | 1) & __mask_;
+                __bucket_ = __permute(0);
+                if (__bucket_ < __bucket_count_ && __buckets_[__bucket_] != nullptr)
+                    __node_ = __buckets_[__bucket_]->__next_;
+                else
+                    __next_bucket();
+            }
+
+            // A bijection of [0, __mask_ + 1): adding a constant, multiplying by
+            // an odd one and x ^= x >> s (s >= 1) are each invertible modulo a
+            // power of two. Two keyed rounds are enough to break up the strides
+            // a single LCG leaves between consecutive buckets.
+            _LIBCPP_INLINE_VISIBILITY
+            size_t __permute(size_t __x) const _NOEXCEPT
+            {
+                __x = ((__x + __key_[0]) * __key_[1]) & __mask_;
+                __x ^= __x >> __shift_;
+                __x = ((__x + __key_[2]) * __key_[3]) & __mask_;
+                __x ^= __x >> __shift_;
+                return __x;
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            void __next_bucket() _NOEXCEPT
+            {
+                __node_ = nullptr;
+                while (__step_ != __mask_)
+                {
+                    __bucket_ = __permute(++__step_);
+                    if (__bucket_ < __bucket_count_ && __buckets_[__bucket_] != nullptr)
+                    {
+                        __node_ = __buckets_[__bucket_]->__next_;
+                        break;
+                    }
+                }
+            }
+
+            template <class, class, class, class, class> friend class __hash_table;
+        };
+
+        // Map from a grid cell to the cell swapped into it, for the lazy
+        // Fisher-Yates of __hash_lazy_random_iterator; a cell never written
+        // maps to itself. Open addressing over (key + 1, value) pairs, 0
+        // marking a free slot, kept at most half full. Nothing is allocated
+        // until the first __put.
+        template <class _SizeType, class _Alloc>
+        class __hash_swap_map
+        {
+            vector<_SizeType, _Alloc> __slots_;
+            _SizeType                 __size_;
+
+            _LIBCPP_INLINE_VISIBILITY
+            size_t __slot(_SizeType __k) const _NOEXCEPT
+            {
+                size_t __mask = __slots_.size() / 2 - 1;
+                size_t __i = static_cast<size_t>(__k) * static_cast<size_t>(0x9E3779B97F4A7C15ULL);
+                __i = (__i ^ (__i >> 29)) & __mask;
+                while (__slots_[2 * __i] != 0 && __slots_[2 * __i] != __k + 1)
+                    __i = (__i + 1) & __mask;
+                return 2 * __i;
+            }
+
+            void __grow()
+            {
+                vector<_SizeType, _Alloc> __old(__slots_.empty() ? 2 * 16 : 2 * __slots_.size(), 0,
+                                                __slots_.get_allocator());
+                __old.swap(__slots_);
+                for (size_t __i = 0; __i < __old.size(); __i += 2)
+                {
+                    if (__old[__i] != 0)
+                    {
+                        size_t __s = __slot(__old[__i] - 1);
+                        __slots_[__s] = __old[__i];
+                        __slots_[__s + 1] = __old[__i + 1];
+                    }
+                }
+            }
+
+        public:
+            _LIBCPP_INLINE_VISIBILITY
+            explicit __hash_swap_map(const _Alloc& __a) : __slots_(__a), __size_(0) {}
+
+            _LIBCPP_INLINE_VISIBILITY
+            _SizeType __get(_SizeType __k) const _NOEXCEPT
+            {
+                if (__slots_.empty())
+                    return __k;
+                size_t __s = __slot(__k);
+                return __slots_[__s] != 0 ? __slots_[__s + 1] : __k;
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            void __put(_SizeType __k, _SizeType __v)
+            {
+                if (2 * (__size_ + 1) > __slots_.size() / 2)
+                    __grow();
+                size_t __s = __slot(__k);
+                if (__slots_[__s] == 0)
+                {
+                    __slots_[__s] = __k + 1;
+                    ++__size_;
+                }
+                __slots_[__s + 1] = __v;
+            }
+        };
+
+        // Produces a uniformly random order one element at a time; each
+        // increment runs one more step of a lazy Fisher-Yates, so a loop that
+        // stops after k elements pays for k steps, not for size(). Each
+        // iterator carries its own swap map, so any number of them may be in
+        // use at once, but the table must not be modified while one is.
+        // Copying one copies its map.
+        template <class _Table, class _URBG>
+        class _LIBCPP_TEMPLATE_VIS __hash_lazy_random_iterator
+        {
+            typedef typename _Table::__next_pointer   __next_pointer;
+            typedef typename _Table::size_type        size_type;
+            typedef typename _Table::__size_allocator __size_allocator;
+
+            const _Table*                                __table_;
+            _URBG*                                       __g_;
+            size_type                                    __pos_;
+            size_type                                    __bound_;
+            __next_pointer                               __node_;
+            __hash_swap_map<size_type, __size_allocator> __map_;
+
+        public:
+            typedef input_iterator_tag                       iterator_category;
+            typedef typename _Table::value_type              value_type;
+            typedef typename _Table::difference_type         difference_type;
+            typedef const value_type&                        reference;
+            typedef typename _Table::const_pointer           pointer;
+
+            _LIBCPP_INLINE_VISIBILITY __hash_lazy_random_iterator()
+                    : __table_(nullptr), __g_(nullptr), __pos_(0), __bound_(0), __node_(nullptr),
+                      __map_(__size_allocator()) {}
 
             _LIBCPP_INLINE_VISIBILITY
             reference operator*() const {
-                _LIBCPP_DEBUG_ASSERT(__get_const_db()->__dereferenceable(this),
-                                     "Attempted to dereference a non-dereferenceable unordered container const_local_iterator");
                 return __node_->__upcast()->__value_;
             }
 
             _LIBCPP_INLINE_VISIBILITY
             pointer operator->() const {
-                _LIBCPP_DEBUG_ASSERT(__get_const_db()->__dereferenceable(this),
-                                     "Attempted to dereference a non-dereferenceable unordered container const_local_iterator");
                 return pointer_traits<pointer>::pointer_to(__node_->__upcast()->__value_);
             }
 
             _LIBCPP_INLINE_VISIBILITY
-            __hash_const_local_iterator& operator++() {
-                _LIBCPP_DEBUG_ASSERT(__get_const_db()->__dereferenceable(this),
-                                     "Attempted to increment non-incrementable unordered container const_local_iterator");
-                __node_ = __node_->__next_;
-                if (__node_ != nullptr && __constrain_hash(__node_->__hash(), __bucket_count_) != __bucket_)
-                    __node_ = nullptr;
+            __hash_lazy_random_iterator& operator++() {
+                __node_ = __table_->__lazy_random_next(__pos_, __bound_, __map_, *__g_);
                 return *this;
             }
 
             _LIBCPP_INLINE_VISIBILITY
-            __hash_const_local_iterator operator++(int)
-            {
-                __hash_const_local_iterator __t(*this);
-                ++(*this);
-                return __t;
-            }
+            void operator++(int) {++(*this);}
 
             friend _LIBCPP_INLINE_VISIBILITY
-            bool operator==(const __hash_const_local_iterator& __x, const __hash_const_local_iterator& __y)
+            bool operator==(const __hash_lazy_random_iterator& __x, const __hash_lazy_random_iterator& __y)
             {
                 return __x.__node_ == __y.__node_;
             }
             friend _LIBCPP_INLINE_VISIBILITY
-            bool operator!=(const __hash_const_local_iterator& __x, const __hash_const_local_iterator& __y)
+            bool operator!=(const __hash_lazy_random_iterator& __x, const __hash_lazy_random_iterator& __y)
             {return !(__x == __y);}
 
         private:
-#if _LIBCPP_DEBUG_LEVEL >= 2
             _LIBCPP_INLINE_VISIBILITY
-    __hash_const_local_iterator(__next_pointer __node, size_t __bucket,
-                                size_t __bucket_count, const void* __c) _NOEXCEPT
-        : __node_(__node),
-          __bucket_(__bucket),
-          __bucket_count_(__bucket_count)
-        {
-            __get_db()->__insert_ic(this, __c);
-            if (__node_ != nullptr)
-                __node_ = __node_->__next_;
-        }
-#else
+            explicit __hash_lazy_random_iterator(const __size_allocator& __a) _NOEXCEPT
+                    : __table_(nullptr), __g_(nullptr), __pos_(0), __bound_(0), __node_(nullptr),
+                      __map_(__a) {}
+
             _LIBCPP_INLINE_VISIBILITY
-            __hash_const_local_iterator(__next_pointer __node, size_t __bucket,
-                                        size_t __bucket_count) _NOEXCEPT
-                    : __node_(__node),
-                      __bucket_(__bucket),
-                      __bucket_count_(__bucket_count)
+            __hash_lazy_random_iterator(const _Table* __t, _URBG* __g, size_type __bound,
+                                        const __size_allocator& __a)
+                    : __table_(__t), __g_(__g), __pos_(0), __bound_(__bound), __map_(__a)
             {
-                if (__node_ != nullptr)
-                    __node_ = __node_->__next_;
+                __node_ = __table_->__lazy_random_next(__pos_, __bound_, __map_, *__g_);
             }
+
+            template <class, class, class, class, class> friend class __hash_table;
+        };
+        // END CODE
+
+        // Large bucket arrays can be placed in an anonymous mapping instead of
+        // coming from the allocator, so that the random accesses of find() and
+        // __rehash() hit 2 MiB pages rather than 4 KiB ones. The mapping is
+        // rounded up to and aligned on 2 MiB. Explicit huge pages
+        // (MAP_HUGETLB) are used if the system has reserved some; otherwise the
+        // range is handed to transparent huge pages with MADV_HUGEPAGE. Where
+        // neither is available __hash_huge_page_allocate returns null and the
+        // caller falls back to its allocator.
+        static const size_t __hash_huge_page_size = size_t(1) << 21;
+
+        inline _LIBCPP_INLINE_VISIBILITY
+        size_t __hash_huge_page_length(size_t __bytes) _NOEXCEPT
+        {
+            return (__bytes + (__hash_huge_page_size - 1)) & ~(__hash_huge_page_size - 1);
+        }
+
+        inline _LIBCPP_INLINE_VISIBILITY
+        void* __hash_huge_page_allocate(size_t __bytes) _NOEXCEPT
+        {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+            size_t __len = __hash_huge_page_length(__bytes);
+            if (__len < __bytes || __len + __hash_huge_page_size < __len)
+                return nullptr;
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_2MB)
+            void* __h = ::mmap(nullptr, __len, PROT_READ | PROT_WRITE,
+                               MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_2MB, -1, 0);
+            if (__h != MAP_FAILED)
+                return __h;
 #endif
-            template <class, class, class, class> friend class __hash_table;
-            template <class> friend class _LIBCPP_TEMPLATE_VIS __hash_map_const_iterator;
+            // Over-map by one huge page and trim, so the range starts on a
+            // 2 MiB boundary and every page of it can be a huge one.
+            void* __m = ::mmap(nullptr, __len + __hash_huge_page_size, PROT_READ | PROT_WRITE,
+                               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (__m == MAP_FAILED)
+                return nullptr;
+            char* __first = static_cast<char*>(__m);
+            char* __p = reinterpret_cast<char*>(
+                    (reinterpret_cast<uintptr_t>(__first) + (__hash_huge_page_size - 1)) &
+                    ~uintptr_t(__hash_huge_page_size - 1));
+            if (__p != __first)
+                ::munmap(__first, static_cast<size_t>(__p - __first));
+            size_t __tail = static_cast<size_t>(__first + __hash_huge_page_size - __p);
+            if (__tail != 0)
+                ::munmap(__p + __len, __tail);
+            ::madvise(__p, __len, MADV_HUGEPAGE);
+            return __p;
+#else
+            (void)__bytes;
+            return nullptr;
+#endif
+        }
+
+        inline _LIBCPP_INLINE_VISIBILITY
+        void __hash_huge_page_deallocate(void* __p, size_t __bytes) _NOEXCEPT
+        {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+            ::munmap(__p, __hash_huge_page_length(__bytes));
+#else
+            (void)__p;
+            (void)__bytes;
+#endif
+        }
+
+        // A flag of a bucket array that only tables with the matching
+        // hash_bucket_features member keep; without it the flag reads false
+        // and takes no space. _Id makes the deleter's two flags distinct
+        // types, so that both can be empty bases.
+        template <bool _Enabled, int _Id>
+        class __hash_array_flag
+        {
+            bool __on_;
+
+        public:
+            _LIBCPP_INLINE_VISIBILITY
+            __hash_array_flag() _NOEXCEPT : __on_(false) {}
+
+            _LIBCPP_INLINE_VISIBILITY
+            bool __get() const _NOEXCEPT {return __on_;}
+            _LIBCPP_INLINE_VISIBILITY
+            void __set(bool __on) _NOEXCEPT {__on_ = __on;}
         };
 
-        template <class _Alloc>
+        template <int _Id>
+        class __hash_array_flag<false, _Id>
+        {
+        public:
+            _LIBCPP_INLINE_VISIBILITY
+            bool __get() const _NOEXCEPT {return false;}
+            _LIBCPP_INLINE_VISIBILITY
+            void __set(bool) _NOEXCEPT {}
+        };
+
+        // Besides the allocator and size() of the bucket array, the deleter
+        // keeps what was decided about the array when it was allocated: the
+        // reciprocal of size(), whether it came from __hash_huge_page_allocate
+        // (__mapped()), and whether one fingerprint byte per bucket follows
+        // the pointers in the same allocation (__tagged()). Each is an empty
+        // base unless _Features asks for it, leaving libc++'s layout. With
+        // _Bounded the pointers are followed by a word for the table's cached
+        // bucket size bound, ahead of any fingerprint bytes.
+        template <class _Alloc, class _Features, bool _Bounded>
         class __bucket_list_deallocator
+                : private __hash_reciprocal<_Features::fast_modulo::value, _Features::pow2_mixing::value>,
+                  private __hash_array_flag<_Features::huge_pages::value, 0>,
+                  private __hash_array_flag<_Features::fingerprints::value, 1>
         {
             typedef _Alloc                                          allocator_type;
             typedef allocator_traits<allocator_type>                __alloc_traits;
             typedef typename __alloc_traits::size_type              size_type;
+            typedef __hash_array_flag<_Features::huge_pages::value, 0>   __mapped_flag;
+            typedef __hash_array_flag<_Features::fingerprints::value, 1> __tagged_flag;
+        public:
+            typedef __hash_reciprocal<_Features::fast_modulo::value, _Features::pow2_mixing::value>
+                    __reciprocal_type;
+        private:
 
             __compressed_pair<size_type, allocator_type> __data_;
         public:
@@ -800,16 +2196,19 @@ struct __hash_value_type;
             _LIBCPP_INLINE_VISIBILITY
             __bucket_list_deallocator(const allocator_type& __a, size_type __size)
             _NOEXCEPT_(is_nothrow_copy_constructible<allocator_type>::value)
-                    : __data_(__size, __a) {}
+                    : __reciprocal_type(__size), __data_(__size, __a) {}
 
 #ifndef _LIBCPP_HAS_NO_RVALUE_REFERENCES
 
             _LIBCPP_INLINE_VISIBILITY
             __bucket_list_deallocator(__bucket_list_deallocator&& __x)
             _NOEXCEPT_(is_nothrow_move_constructible<allocator_type>::value)
-                    : __data_(_VSTD::move(__x.__data_))
+                    : __reciprocal_type(__x.__reciprocal()),
+                      __mapped_flag(__x),
+                      __tagged_flag(__x),
+                      __data_(_VSTD::move(__x.__data_))
             {
-                __x.size() = 0;
+                __x.__drop_array();
             }
 
 #endif  // _LIBCPP_HAS_NO_RVALUE_REFERENCES
@@ -824,10 +2223,75 @@ struct __hash_value_type;
             _LIBCPP_INLINE_VISIBILITY
             const allocator_type& __alloc() const _NOEXCEPT {return __data_.second();}
 
+            _LIBCPP_INLINE_VISIBILITY
+            __reciprocal_type& __reciprocal() _NOEXCEPT {return *this;}
+            _LIBCPP_INLINE_VISIBILITY
+            const __reciprocal_type& __reciprocal() const _NOEXCEPT {return *this;}
+
+            _LIBCPP_INLINE_VISIBILITY
+            bool __mapped() const _NOEXCEPT {return __mapped_flag::__get();}
+            _LIBCPP_INLINE_VISIBILITY
+            void __set_mapped(bool __on) _NOEXCEPT {__mapped_flag::__set(__on);}
+
+            _LIBCPP_INLINE_VISIBILITY
+            bool __tagged() const _NOEXCEPT {return __tagged_flag::__get();}
+            _LIBCPP_INLINE_VISIBILITY
+            void __set_tagged(bool __on) _NOEXCEPT {__tagged_flag::__set(__on);}
+
+            // Elements taken by the cached bound after the bucket pointers.
+            _LIBCPP_INLINE_VISIBILITY
+            static size_type __bound_words() _NOEXCEPT
+            {
+                const size_type __w = sizeof(typename __alloc_traits::value_type);
+                return _Bounded ? (sizeof(size_t) + __w - 1) / __w : 0;
+            }
+
+            // Elements allocated for __n buckets, cached bound and fingerprint
+            // bytes included.
+            _LIBCPP_INLINE_VISIBILITY
+            static size_type __words(size_type __n, bool __tagged) _NOEXCEPT
+            {
+                const size_type __w = sizeof(typename __alloc_traits::value_type);
+                const size_type __k = __n + __bound_words();
+                return __tagged ? __k + (__n + __w - 1) / __w : __k;
+            }
+
+            // What describes the array goes with it when the unique_ptr's
+            // pointer is handed over; the allocator does not.
+            _LIBCPP_INLINE_VISIBILITY
+            void __drop_array() _NOEXCEPT
+            {
+                size() = 0;
+                __reciprocal() = __reciprocal_type();
+                __set_mapped(false);
+                __set_tagged(false);
+            }
+            _LIBCPP_INLINE_VISIBILITY
+            void __take_array(__bucket_list_deallocator& __x) _NOEXCEPT
+            {
+                size() = __x.size();
+                __reciprocal() = __x.__reciprocal();
+                __set_mapped(__x.__mapped());
+                __set_tagged(__x.__tagged());
+                __x.__drop_array();
+            }
+            _LIBCPP_INLINE_VISIBILITY
+            void __swap_array(__bucket_list_deallocator& __x) _NOEXCEPT
+            {
+                _VSTD::swap(size(), __x.size());
+                _VSTD::swap(__reciprocal(), __x.__reciprocal());
+                _VSTD::swap(static_cast<__mapped_flag&>(*this), static_cast<__mapped_flag&>(__x));
+                _VSTD::swap(static_cast<__tagged_flag&>(*this), static_cast<__tagged_flag&>(__x));
+            }
+
             _LIBCPP_INLINE_VISIBILITY
             void operator()(pointer __p) _NOEXCEPT
             {
-                __alloc_traits::deallocate(__alloc(), __p, size());
+                size_type __n = __words(size(), __tagged());
+                if (__mapped())
+                    __hash_huge_page_deallocate(_VSTD::addressof(*__p), __n * sizeof(*__p));
+                else
+                    __alloc_traits::deallocate(__alloc(), __p, __n);
             }
         };
 
@@ -870,8 +2334,11 @@ struct __hash_value_type;
             template <class> friend class __hash_map_node_destructor;
         };
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         class __hash_table
+                : private __hash_order_state<_Order>,
+                  private __hash_bucket_options<
+                          hash_bucket_features<typename __hash_key_value_types<_Tp>::key_type, _Hash> >
         {
         public:
             typedef _Tp    value_type;
@@ -882,7 +2349,9 @@ struct __hash_value_type;
         private:
             typedef allocator_traits<allocator_type> __alloc_traits;
             typedef typename
-            __make_hash_node_types<value_type, typename __alloc_traits::void_pointer>::type
+            __make_hash_node_types<value_type, typename __alloc_traits::void_pointer,
+                                   cache_hash_code<typename __hash_key_value_types<_Tp>::key_type,
+                                                   _Hash>::value>::type
                     _NodeTypes;
         public:
 
@@ -926,11 +2395,17 @@ struct __hash_value_type;
 
         private:
 
+            typedef hash_bucket_features<key_type, hasher>        __features;
+            typedef __hash_bucket_options<__features>             __bucket_options;
             typedef typename __rebind_alloc_helper<__node_traits, __next_pointer>::type __pointer_allocator;
-            typedef __bucket_list_deallocator<__pointer_allocator> __bucket_list_deleter;
+            typedef __hash_iteration_traits<_Order>               __order_traits;
+            typedef __bucket_list_deallocator<__pointer_allocator, __features,
+                                              !__order_traits::__shuffles::value> __bucket_list_deleter;
+            typedef typename __bucket_list_deleter::__reciprocal_type __reciprocal_type;
             typedef unique_ptr<__next_pointer[], __bucket_list_deleter> __bucket_list;
             typedef allocator_traits<__pointer_allocator>          __pointer_alloc_traits;
             typedef typename __bucket_list_deleter::pointer       __node_pointer_pointer;
+            typedef typename __rebind_alloc_helper<__node_traits, size_type>::type __size_allocator;
 
             // --- Member data begin ---
             __bucket_list                                         __bucket_list_;
@@ -938,6 +2413,23 @@ struct __hash_value_type;
             __compressed_pair<size_type, hasher>                  __p2_;
             __compressed_pair<float, key_equal>                   __p3_;
             // --- Member data end ---
+            //
+            // The rest is in the bases, and empty unless _Order shuffles or
+            // __features asks for it:
+            //  - __hash_order_state<_Order>: the generator and shuffle options
+            //    of begin() and reshuffle(), and the shuffle bookkeeping.
+            //  - __bucket_options: with __fingerprinted(), bucket arrays are
+            //    allocated with one byte per bucket after the pointers (see
+            //    __fingerprints()), with bit __fingerprint(h) set for the hash
+            //    h of every node in the bucket, and a lookup whose bit is clear
+            //    misses without touching the bucket slot or the nodes. Arrays
+            //    of at least __huge_page_threshold() bytes, if that is not 0,
+            //    come from __hash_huge_page_allocate when it succeeds. With
+            //    __pow2_mixing(), rehash() picks powers of two for
+            //    bucket_count() and buckets are indexed by Fibonacci hashing.
+            //
+            // An ordered table's bucket arrays also end in a word caching the
+            // samplers' bound (see __sampling_bound()), so it costs no member.
 
             _LIBCPP_INLINE_VISIBILITY
             size_type& size() _NOEXCEPT {return __p2_.first();}
@@ -969,8 +2461,22 @@ struct __hash_value_type;
         public:
             typedef __hash_iterator<__node_pointer>                   iterator;
             typedef __hash_const_iterator<__node_pointer>             const_iterator;
-            typedef __hash_local_iterator<__node_pointer>             local_iterator;
-            typedef __hash_const_local_iterator<__node_pointer>       const_local_iterator;
+            typedef integral_constant<bool, _NodeTypes::__caches_hash> __caches_hash;
+        private:
+            // What the bucket-walking iterators carry to recompute a node's
+            // hash: nothing when the node caches it, else a copy of the hasher.
+            typedef typename conditional<__caches_hash::value, void, hasher>::type __iterator_hasher;
+        public:
+            typedef __hash_local_iterator<__node_pointer, __iterator_hasher, __reciprocal_type>
+                    local_iterator;
+            typedef __hash_const_local_iterator<__node_pointer, __iterator_hasher, __reciprocal_type>
+                    const_local_iterator;
+            typedef __hash_random_iterator<__node_pointer, __iterator_hasher, __reciprocal_type>
+                    random_iterator;
+#ifndef _LIBCPP_CXX03_LANG
+            template <class _URBG>
+            using lazy_random_iterator = __hash_lazy_random_iterator<__hash_table, _URBG>;
+#endif
 
             _LIBCPP_INLINE_VISIBILITY
             __hash_table()
@@ -1024,14 +2530,24 @@ struct __hash_value_type;
             }
 
             pair<iterator, bool> __node_insert_unique(__node_pointer __nd);
-            iterator             __node_insert_multi(__node_pointer __nd);
+            _LIBCPP_INLINE_VISIBILITY
+            iterator             __node_insert_multi(__node_pointer __nd)
+            {return __node_insert_multi(__nd, hash_function()(__nd->__value_));}
+            iterator             __node_insert_multi(__node_pointer __nd, size_t __hash);
             iterator             __node_insert_multi(const_iterator __p,
                                                      __node_pointer __nd);
 
 #ifndef _LIBCPP_CXX03_LANG
             template <class _Key, class ..._Args>
             _LIBCPP_INLINE_VISIBILITY
-            pair<iterator, bool> __emplace_unique_key_args(_Key const& __k, _Args&&... __args);
+            pair<iterator, bool> __emplace_unique_key_args(_Key const& __k, _Args&&... __args)
+            {
+                return __emplace_unique_hashed(hash_function()(__k), __k,
+                                               _VSTD::forward<_Args>(__args)...);
+            }
+            template <class _Key, class ..._Args>
+            pair<iterator, bool> __emplace_unique_hashed(size_t __hash, _Key const& __k,
+                                                         _Args&&... __args);
 
             template <class... _Args>
             _LIBCPP_INLINE_VISIBILITY
@@ -1116,7 +2632,10 @@ struct __hash_value_type;
 #else  // !defined(_LIBCPP_CXX03_LANG)
             template <class _Key, class _Args>
     _LIBCPP_INLINE_VISIBILITY
-    pair<iterator, bool> __emplace_unique_key_args(_Key const&, _Args& __args);
+    pair<iterator, bool> __emplace_unique_key_args(_Key const& __k, _Args& __args)
+        {return __emplace_unique_hashed(hash_function()(__k), __k, __args);}
+    template <class _Key, class _Args>
+    pair<iterator, bool> __emplace_unique_hashed(size_t __hash, _Key const& __k, _Args& __args);
 
     iterator __insert_multi(const __container_value_type& __x);
     iterator __insert_multi(const_iterator __p, const __container_value_type& __x);
@@ -1127,6 +2646,34 @@ struct __hash_value_type;
                 return __emplace_unique_key_args(_NodeTypes::__get_key(__x), __x);
             }
 
+            // The *_hashed members take the key's hash_function() value from
+            // the caller instead of computing it; unordered_set and
+            // unordered_multiset check it in debug mode.
+            _LIBCPP_INLINE_VISIBILITY
+            pair<iterator, bool> __insert_unique_hashed(size_t __hash, const __container_value_type& __x) {
+                return __emplace_unique_hashed(__hash, _NodeTypes::__get_key(__x), __x);
+            }
+            _LIBCPP_INLINE_VISIBILITY
+            iterator __insert_multi_hashed(size_t __hash, const __container_value_type& __x) {
+                __node_holder __h = __construct_node_hash(__hash, __x);
+                iterator __r = __node_insert_multi(__h.get(), __hash);
+                __h.release();
+                return __r;
+            }
+#ifndef _LIBCPP_CXX03_LANG
+            _LIBCPP_INLINE_VISIBILITY
+            pair<iterator, bool> __insert_unique_hashed(size_t __hash, __container_value_type&& __x) {
+                return __emplace_unique_hashed(__hash, _NodeTypes::__get_key(__x), _VSTD::move(__x));
+            }
+            _LIBCPP_INLINE_VISIBILITY
+            iterator __insert_multi_hashed(size_t __hash, __container_value_type&& __x) {
+                __node_holder __h = __construct_node_hash(__hash, _VSTD::move(__x));
+                iterator __r = __node_insert_multi(__h.get(), __hash);
+                __h.release();
+                return __r;
+            }
+#endif
+
             void clear() _NOEXCEPT;
             void rehash(size_type __n);
             _LIBCPP_INLINE_VISIBILITY void reserve(size_type __n)
@@ -1140,8 +2687,42 @@ struct __hash_value_type;
 
             _LIBCPP_INLINE_VISIBILITY
             iterator       begin() _NOEXCEPT;
+            // begin() as seen through _Order: hash order for ordered_iteration,
+            // begin_random() otherwise. There is no const overload: shuffling
+            // relinks the chain, so a const begin() is the plain one.
+            _LIBCPP_INLINE_VISIBILITY
+            iterator       __iteration_begin() _NOEXCEPT
+            {return __iteration_begin(typename __order_traits::__shuffles());}
             _LIBCPP_INLINE_VISIBILITY
             iterator       begin_random() _NOEXCEPT;
+            _LIBCPP_INLINE_VISIBILITY
+            iterator       reshuffle() _NOEXCEPT;
+            _LIBCPP_INLINE_VISIBILITY
+            void           seed(unsigned long long __s) _NOEXCEPT
+            {
+                static_assert(__order_traits::__shuffles::value,
+                              "seed() needs a shuffling iteration order; "
+                              "ordered_iteration tables have no generator");
+                this->__rng().seed(__s);
+            }
+            template <class _URBG>
+            iterator       begin_random(_URBG&& __g);
+            template <class _URBG>
+            random_iterator random_begin(_URBG&& __g) const;
+            _LIBCPP_INLINE_VISIBILITY
+            random_iterator random_end() const _NOEXCEPT {return random_iterator();}
+            template <class _URBG, class _OutputIterator>
+            _OutputIterator __sample(size_type __k, _URBG&& __g, _OutputIterator __out) const;
+            template <class _URBG>
+            const_iterator __random_element(_URBG&& __g) const;
+#ifndef _LIBCPP_CXX03_LANG
+            template <class _URBG>
+            lazy_random_iterator<_URBG> lazy_random_begin(_URBG& __g) const;
+            template <class _URBG>
+            _LIBCPP_INLINE_VISIBILITY
+            lazy_random_iterator<_URBG> lazy_random_end() const _NOEXCEPT
+            {return lazy_random_iterator<_URBG>(__size_allocator(__node_alloc()));}
+#endif
             _LIBCPP_INLINE_VISIBILITY
             iterator       end() _NOEXCEPT;
             _LIBCPP_INLINE_VISIBILITY
@@ -1155,13 +2736,19 @@ struct __hash_value_type;
             {
                 _LIBCPP_ASSERT(bucket_count() > 0,
                                "unordered container::bucket(key) called when bucket_count() == 0");
-                return __constrain_hash(hash_function()(__k), bucket_count());
+                return __bucket_index(hash_function()(__k), bucket_count());
             }
 
             template <class _Key>
-            iterator       find(const _Key& __x);
+            _LIBCPP_INLINE_VISIBILITY
+            iterator       find(const _Key& __x) {return find(__x, hash_function()(__x));}
+            template <class _Key>
+            _LIBCPP_INLINE_VISIBILITY
+            const_iterator find(const _Key& __x) const {return find(__x, hash_function()(__x));}
+            template <class _Key>
+            iterator       find(const _Key& __x, size_t __hash);
             template <class _Key>
-            const_iterator find(const _Key& __x) const;
+            const_iterator find(const _Key& __x, size_t __hash) const;
 
             typedef __hash_node_destructor<__node_allocator> _Dp;
             typedef unique_ptr<__node, _Dp> __node_holder;
@@ -1169,9 +2756,17 @@ struct __hash_value_type;
             iterator erase(const_iterator __p);
             iterator erase(const_iterator __first, const_iterator __last);
             template <class _Key>
-            size_type __erase_unique(const _Key& __k);
+            _LIBCPP_INLINE_VISIBILITY
+            size_type __erase_unique(const _Key& __k)
+            {return __erase_unique(__k, hash_function()(__k));}
+            template <class _Key>
+            size_type __erase_unique(const _Key& __k, size_t __hash);
             template <class _Key>
-            size_type __erase_multi(const _Key& __k);
+            _LIBCPP_INLINE_VISIBILITY
+            size_type __erase_multi(const _Key& __k)
+            {return __erase_multi(__k, hash_function()(__k));}
+            template <class _Key>
+            size_type __erase_multi(const _Key& __k, size_t __hash);
             __node_holder remove(const_iterator __p) _NOEXCEPT;
 
             template <class _Key>
@@ -1223,6 +2818,58 @@ struct __hash_value_type;
                 max_load_factor() = _VSTD::max(__mlf, load_factor());
             }
 
+            // The const getters report the defaults under ordered_iteration,
+            // which keeps no options; the setters need a shuffling _Order.
+            _LIBCPP_INLINE_VISIBILITY
+            size_type& parallel_shuffle_threshold() _NOEXCEPT
+            {
+                static_assert(__order_traits::__shuffles::value,
+                              "ordered_iteration tables keep no shuffle options");
+                return this->__shuffle_options().__parallel_threshold_;
+            }
+            _LIBCPP_INLINE_VISIBILITY
+            size_type  parallel_shuffle_threshold() const _NOEXCEPT
+            {return this->__shuffle_options().__parallel_threshold_;}
+            _LIBCPP_INLINE_VISIBILITY
+            unsigned&  shuffle_threads() _NOEXCEPT
+            {
+                static_assert(__order_traits::__shuffles::value,
+                              "ordered_iteration tables keep no shuffle options");
+                return this->__shuffle_options().__threads_;
+            }
+            _LIBCPP_INLINE_VISIBILITY
+            unsigned   shuffle_threads() const _NOEXCEPT {return this->__shuffle_options().__threads_;}
+            _LIBCPP_INLINE_VISIBILITY
+            bool&      shuffle_in_place() _NOEXCEPT
+            {
+                static_assert(__order_traits::__shuffles::value,
+                              "ordered_iteration tables keep no shuffle options");
+                return this->__shuffle_options().__in_place_;
+            }
+            _LIBCPP_INLINE_VISIBILITY
+            bool       shuffle_in_place() const _NOEXCEPT {return this->__shuffle_options().__in_place_;}
+
+            // Without the hash_bucket_features member, the getters report
+            // the feature off and the setters do not compile.
+            _LIBCPP_INLINE_VISIBILITY
+            bool bucket_fingerprints() const _NOEXCEPT {return this->__fingerprinted();}
+            _LIBCPP_INLINE_VISIBILITY
+            void bucket_fingerprints(bool __on)
+            {
+                static_assert(__features::fingerprints::value,
+                              "bucket_fingerprints() needs hash_bucket_features<Key, Hash>::fingerprints");
+                this->__set_fingerprinted(__on);
+                __apply_fingerprint_setting();
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            size_type bucket_huge_pages() const _NOEXCEPT {return this->__huge_page_threshold();}
+            void bucket_huge_pages(size_type __min_bytes);
+
+            _LIBCPP_INLINE_VISIBILITY
+            bool bucket_pow2_mixing() const _NOEXCEPT {return this->__pow2_mixing();}
+            void bucket_pow2_mixing(bool __on);
+
             _LIBCPP_INLINE_VISIBILITY
             local_iterator
             begin(size_type __n)
@@ -1230,9 +2877,11 @@ struct __hash_value_type;
                 _LIBCPP_ASSERT(__n < bucket_count(),
                                "unordered container::begin(n) called with n >= bucket_count()");
 #if _LIBCPP_DEBUG_LEVEL >= 2
-                return local_iterator(__bucket_list_[__n], __n, bucket_count(), this);
+                return local_iterator(__bucket_list_[__n], __n, bucket_count(),
+                                      __bucket_list_.get_deleter().__reciprocal(), __hash_source(hash_function()), this);
 #else
-                return local_iterator(__bucket_list_[__n], __n, bucket_count());
+                return local_iterator(__bucket_list_[__n], __n, bucket_count(),
+                                      __bucket_list_.get_deleter().__reciprocal(), __hash_source(hash_function()));
 #endif
             }
 
@@ -1243,49 +2892,269 @@ struct __hash_value_type;
                 _LIBCPP_ASSERT(__n < bucket_count(),
                                "unordered container::end(n) called with n >= bucket_count()");
 #if _LIBCPP_DEBUG_LEVEL >= 2
-                return local_iterator(nullptr, __n, bucket_count(), this);
+                return local_iterator(nullptr, __n, bucket_count(),
+                                      __bucket_list_.get_deleter().__reciprocal(), __hash_source(hash_function()), this);
+#else
+                return local_iterator(nullptr, __n, bucket_count(),
+                                      __bucket_list_.get_deleter().__reciprocal(), __hash_source(hash_function()));
+#endif
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            const_local_iterator
+            cbegin(size_type __n) const
+            {
+                _LIBCPP_ASSERT(__n < bucket_count(),
+                               "unordered container::cbegin(n) called with n >= bucket_count()");
+#if _LIBCPP_DEBUG_LEVEL >= 2
+                return const_local_iterator(__bucket_list_[__n], __n, bucket_count(),
+                                            __bucket_list_.get_deleter().__reciprocal(), __hash_source(hash_function()), this);
+#else
+                return const_local_iterator(__bucket_list_[__n], __n, bucket_count(),
+                                            __bucket_list_.get_deleter().__reciprocal(), __hash_source(hash_function()));
+#endif
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            const_local_iterator
+            cend(size_type __n) const
+            {
+                _LIBCPP_ASSERT(__n < bucket_count(),
+                               "unordered container::cend(n) called with n >= bucket_count()");
+#if _LIBCPP_DEBUG_LEVEL >= 2
+                return const_local_iterator(nullptr, __n, bucket_count(),
+                                            __bucket_list_.get_deleter().__reciprocal(), __hash_source(hash_function()), this);
 #else
-                return local_iterator(nullptr, __n, bucket_count());
+                return const_local_iterator(nullptr, __n, bucket_count(),
+                                            __bucket_list_.get_deleter().__reciprocal(), __hash_source(hash_function()));
 #endif
             }
-
+
+#if _LIBCPP_DEBUG_LEVEL >= 2
+
+            bool __dereferenceable(const const_iterator* __i) const;
+    bool __decrementable(const const_iterator* __i) const;
+    bool __addable(const const_iterator* __i, ptrdiff_t __n) const;
+    bool __subscriptable(const const_iterator* __i, ptrdiff_t __n) const;
+
+#endif  // _LIBCPP_DEBUG_LEVEL >= 2
+
+            // __constrain_hash(__h, __bc), where __bc must be bucket_count().
+            _LIBCPP_INLINE_VISIBILITY
+            size_t __bucket_index(size_t __h, size_type __bc) const _NOEXCEPT
+            {return __constrain_hash(__h, __bc, __bucket_list_.get_deleter().__reciprocal());}
+
+            // The hash of the value in __np, read from the node or, when
+            // cache_hash_code left it out, recomputed.
+            _LIBCPP_INLINE_VISIBILITY
+            size_t __node_hash(__next_pointer __np) const _NOEXCEPT
+            {return __node_hash(__np, __caches_hash());}
+
+        private:
+            typedef __hash_node_hash_source<__next_pointer, __iterator_hasher> __hash_source;
+
+            static_assert(__caches_hash::value ||
+                          (noexcept(_VSTD::declval<const hasher&>()(_VSTD::declval<const key_type&>())) &&
+                           is_nothrow_copy_constructible<hasher>::value),
+                          "a hasher whose hash is not cached in the node must not throw");
+
+            _LIBCPP_INLINE_VISIBILITY
+            size_t __node_hash(__next_pointer __np, true_type) const _NOEXCEPT
+            {return __np->__hash();}
+            _LIBCPP_INLINE_VISIBILITY
+            size_t __node_hash(__next_pointer __np, false_type) const _NOEXCEPT
+            {return hash_function()(__np->__upcast()->__value_);}
+            _LIBCPP_INLINE_VISIBILITY
+            void __set_node_hash(__node_pointer __np, size_t __hash) _NOEXCEPT
+            {__set_node_hash(__np, __hash, __caches_hash());}
+            _LIBCPP_INLINE_VISIBILITY
+            void __set_node_hash(__node_pointer __np, size_t __hash, true_type) _NOEXCEPT
+            {__np->__hash_ = __hash;}
+            _LIBCPP_INLINE_VISIBILITY
+            void __set_node_hash(__node_pointer, size_t, false_type) _NOEXCEPT {}
+            // Fills in the hash of a freshly constructed node, if it has one.
+            _LIBCPP_INLINE_VISIBILITY
+            void __cache_node_hash(__node_pointer __np, true_type)
+            {__np->__hash_ = hash_function()(__np->__value_);}
+            _LIBCPP_INLINE_VISIBILITY
+            void __cache_node_hash(__node_pointer, false_type) _NOEXCEPT {}
+
+            void __rehash(size_type __n);
+            // An insertion into bucket __chash walked __len of its nodes and
+            // left the ones from __rest on unwalked; a shuffling table counts
+            // those too and raises its bucket size bound to the total.
+            _LIBCPP_INLINE_VISIBILITY
+            void __note_bucket_size(size_type __len, __next_pointer __rest,
+                                    size_t __chash, size_type __bc) _NOEXCEPT
+            {__note_bucket_size(__len, __rest, __chash, __bc, typename __order_traits::__shuffles());}
+            _LIBCPP_INLINE_VISIBILITY
+            void __note_bucket_size(size_type __len, __next_pointer __rest,
+                                    size_t __chash, size_type __bc, true_type) _NOEXCEPT
+            {this->__raise_bucket_size_bound(__len + __bucket_rest(__rest, __chash, __bc));}
+            _LIBCPP_INLINE_VISIBILITY
+            void __note_bucket_size(size_type, __next_pointer, size_t, size_type, false_type) _NOEXCEPT
+            {__forget_bucket_size_bound();}
+            // The number of nodes from __np to the end of bucket __chash.
+            _LIBCPP_INLINE_VISIBILITY
+            size_type __bucket_rest(__next_pointer __np, size_t __chash, size_type __bc) const _NOEXCEPT
+            {
+                size_type __n = 0;
+                for (; __np != nullptr && __bucket_index(__node_hash(__np), __bc) == __chash;
+                     __np = __np->__next_)
+                    ++__n;
+                return __n;
+            }
+            size_type __longest_bucket() const _NOEXCEPT;
+            _LIBCPP_INLINE_VISIBILITY
+            void __recount_bucket_size_bound() _NOEXCEPT
+            {__recount_bucket_size_bound(typename __order_traits::__shuffles());}
+            _LIBCPP_INLINE_VISIBILITY
+            void __recount_bucket_size_bound(true_type) _NOEXCEPT
+            {this->__set_bucket_size_bound(__longest_bucket(), size());}
+            _LIBCPP_INLINE_VISIBILITY
+            void __recount_bucket_size_bound(false_type) _NOEXCEPT {}
+            // The bound the samplers draw positions below: kept up to date by a
+            // shuffling table; an ordered one measures it on first use and
+            // caches it in the word after its bucket pointers, which an
+            // insertion or a new array resets to 0. An erasure leaves it be,
+            // as it stays an upper bound. The cache is written from const
+            // members that may run concurrently, hence the atomics; a race
+            // stores the same value twice.
+            _LIBCPP_INLINE_VISIBILITY
+            size_type __sampling_bound() const _NOEXCEPT
+            {return __sampling_bound(typename __order_traits::__shuffles());}
+            _LIBCPP_INLINE_VISIBILITY
+            size_type __sampling_bound(true_type) const _NOEXCEPT
+            {return this->__bucket_size_bound();}
+            _LIBCPP_INLINE_VISIBILITY
+            size_type __sampling_bound(false_type) const _NOEXCEPT
+            {
+                if (size() == 0)
+                    return 0;
+                size_t* __c = __cached_bound();
+                size_t __b = __atomic_load_n(__c, __ATOMIC_RELAXED);
+                if (__b == 0)
+                {
+                    __b = __longest_bucket();
+                    __atomic_store_n(__c, __b, __ATOMIC_RELAXED);
+                }
+                return __b;
+            }
+            // Only an ordered table with buckets has the word.
+            _LIBCPP_INLINE_VISIBILITY
+            size_t* __cached_bound() const _NOEXCEPT
+            {
+                return reinterpret_cast<size_t*>(
+                    _VSTD::addressof(__bucket_list_[0]) + bucket_count());
+            }
+            _LIBCPP_INLINE_VISIBILITY
+            void __forget_bucket_size_bound() _NOEXCEPT
+            {
+                if (__bucket_list_deleter::__bound_words() != 0 && bucket_count() != 0)
+                    __atomic_store_n(__cached_bound(), size_t(0), __ATOMIC_RELAXED);
+            }
+            // Bit of a bucket's fingerprint byte that stands for __hash. It
+            // must not follow from the bucket index, which is the low bits,
+            // a remainder, or with bucket_pow2_mixing() the top bits of
+            // __hash times the golden ratio. So it is the top bits of a
+            // different multiplier applied after folding the high half of
+            // __hash into the low one.
+            _LIBCPP_INLINE_VISIBILITY
+            static unsigned char __fingerprint(size_t __hash) _NOEXCEPT
+            {
+                const int __digits = numeric_limits<size_t>::digits;
+                __hash ^= __hash >> (__digits / 2);
+                return static_cast<unsigned char>(1u << ((__hash * static_cast<size_t>(0xC2B2AE3D27D4EB4FULL))
+                                                         >> (__digits - 3)));
+            }
+            // The fingerprint bytes that follow the bucket pointers, or null
+            // when the array carries none.
+            _LIBCPP_INLINE_VISIBILITY
+            unsigned char* __fingerprints() const _NOEXCEPT
+            {
+                if (!__bucket_list_.get_deleter().__tagged())
+                    return nullptr;
+                return reinterpret_cast<unsigned char*>(
+                    _VSTD::addressof(__bucket_list_[0]) + bucket_count() +
+                    __bucket_list_deleter::__bound_words());
+            }
+            _LIBCPP_INLINE_VISIBILITY
+            bool __fingerprint_rejects(size_t __chash, size_t __hash) const _NOEXCEPT
+            {
+                unsigned char* __f = __fingerprints();
+                return __f != nullptr && !(__f[__chash] & __fingerprint(__hash));
+            }
+            _LIBCPP_INLINE_VISIBILITY
+            void __fingerprint_add(size_t __chash, size_t __hash) _NOEXCEPT
+            {
+                if (unsigned char* __f = __fingerprints())
+                    __f[__chash] |= __fingerprint(__hash);
+            }
+            _LIBCPP_INLINE_VISIBILITY
+            void __clear_fingerprints() _NOEXCEPT
+            {
+                if (unsigned char* __f = __fingerprints())
+                    _VSTD::fill(__f, __f + bucket_count(), 0);
+            }
+            void __refresh_fingerprint(size_t __chash) _NOEXCEPT;
+            void __fill_fingerprints() _NOEXCEPT;
+            // Reallocates the bucket array when it does not match
+            // bucket_fingerprints().
             _LIBCPP_INLINE_VISIBILITY
-            const_local_iterator
-            cbegin(size_type __n) const
+            void __apply_fingerprint_setting()
             {
-                _LIBCPP_ASSERT(__n < bucket_count(),
-                               "unordered container::cbegin(n) called with n >= bucket_count()");
-#if _LIBCPP_DEBUG_LEVEL >= 2
-                return const_local_iterator(__bucket_list_[__n], __n, bucket_count(), this);
-#else
-                return const_local_iterator(__bucket_list_[__n], __n, bucket_count());
-#endif
+                if (bucket_count() != 0 &&
+                    __bucket_list_.get_deleter().__tagged() != this->__fingerprinted())
+                    __rehash(bucket_count());
             }
-
             _LIBCPP_INLINE_VISIBILITY
-            const_local_iterator
-            cend(size_type __n) const
+            bool __wants_huge_pages(size_type __words) const _NOEXCEPT
             {
-                _LIBCPP_ASSERT(__n < bucket_count(),
-                               "unordered container::cend(n) called with n >= bucket_count()");
-#if _LIBCPP_DEBUG_LEVEL >= 2
-                return const_local_iterator(nullptr, __n, bucket_count(), this);
-#else
-                return const_local_iterator(nullptr, __n, bucket_count());
-#endif
+                size_type __t = this->__huge_page_threshold();
+                return __t != 0 && __words >= (__t - 1) / sizeof(__next_pointer) + 1;
             }
-
-#if _LIBCPP_DEBUG_LEVEL >= 2
-
-            bool __dereferenceable(const const_iterator* __i) const;
-    bool __decrementable(const const_iterator* __i) const;
-    bool __addable(const const_iterator* __i, ptrdiff_t __n) const;
-    bool __subscriptable(const const_iterator* __i, ptrdiff_t __n) const;
-
-#endif  // _LIBCPP_DEBUG_LEVEL >= 2
-
-        private:
-            void __rehash(size_type __n);
+            _LIBCPP_INLINE_VISIBILITY
+            __node_pointer_pointer __allocate_buckets(size_type __words, bool& __mapped)
+            {return __allocate_buckets(__words, __mapped, is_pointer<__node_pointer_pointer>());}
+            __node_pointer_pointer __allocate_buckets(size_type __words, bool& __mapped, true_type);
+            _LIBCPP_INLINE_VISIBILITY
+            __node_pointer_pointer __allocate_buckets(size_type __words, bool& __mapped, false_type)
+            {
+                __mapped = false;
+                return __pointer_alloc_traits::allocate(__bucket_list_.get_deleter().__alloc(), __words);
+            }
+            _LIBCPP_INLINE_VISIBILITY
+            iterator __iteration_begin(false_type) _NOEXCEPT {return begin();}
+            _LIBCPP_INLINE_VISIBILITY
+            iterator __iteration_begin(true_type) _NOEXCEPT {return begin_random();}
+            template <class _URBG>
+            __next_pointer __random_node(_URBG& __g, size_type __bound) const;
+            template <class _URBG>
+            __next_pointer __lazy_random_next(size_type& __pos, size_type __bound,
+                                              __hash_swap_map<size_type, __size_allocator>& __m,
+                                              _URBG& __g) const;
+            // What __merge_shuffle moves as one piece: a node, a run of equal
+            // keys, or all of a bucket's nodes.
+            enum __shuffle_unit {__node_unit, __key_unit, __bucket_unit};
+            __next_pointer __unit_last(__next_pointer __np, __shuffle_unit __u,
+                                       size_type __bc) const;
+            template <class _URBG>
+            __next_pointer __merge_shuffle(__next_pointer __h, size_type __n,
+                                           __shuffle_unit __u, size_type __bc, _URBG& __g,
+                                           __next_pointer& __last, __next_pointer& __rest) const;
+            template <class _URBG>
+            __next_pointer __shuffle_run(__next_pointer __h, size_type __n, _URBG& __g,
+                                         __next_pointer& __last) const;
+            template <class _URBG>
+            void __shuffle_in_place(_URBG& __g);
+            template <class _URBG>
+            void __shuffle_relink(_URBG& __g);
+            void __collect_bucket_runs(vector<__next_pointer>& __nodes,
+                                       vector<pair<size_type, size_type> >& __runs) const;
+#if !defined(_LIBCPP_CXX03_LANG) && !defined(_LIBCPP_HAS_NO_THREADS)
+            template <class _URBG>
+            void __shuffle_parallel(_URBG& __g, unsigned __nt);
+#endif
 
 #ifndef _LIBCPP_CXX03_LANG
             template <class ..._Args>
@@ -1339,13 +3208,21 @@ struct __hash_value_type;
             void __deallocate_node(__next_pointer __np) _NOEXCEPT;
             __next_pointer __detach() _NOEXCEPT;
 
+            template <class, class> friend class _LIBCPP_TEMPLATE_VIS __hash_lazy_random_iterator;
             template <class, class, class, class, class> friend class _LIBCPP_TEMPLATE_VIS unordered_map;
             template <class, class, class, class, class> friend class _LIBCPP_TEMPLATE_VIS unordered_multimap;
         };
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        // An ordered_iteration table with the default hash_bucket_features is
+        // laid out as libc++'s: bucket array and bucket_count(), first node,
+        // size(), and max_load_factor() padded to a word.
+        static_assert(sizeof(__hash_table<int, hash<int>, equal_to<int>, allocator<int>,
+                                          ordered_iteration>) == 5 * sizeof(void*),
+                      "ordered_iteration tables must keep libc++'s layout");
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         inline
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__hash_table()
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__hash_table()
         _NOEXCEPT_(
                 is_nothrow_default_constructible<__bucket_list>::value &&
                 is_nothrow_default_constructible<__first_node>::value &&
@@ -1357,9 +3234,9 @@ struct __hash_value_type;
         {
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         inline
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__hash_table(const hasher& __hf,
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__hash_table(const hasher& __hf,
                                                                const key_equal& __eql)
                 : __bucket_list_(nullptr, __bucket_list_deleter()),
                   __p1_(),
@@ -1368,8 +3245,8 @@ struct __hash_value_type;
         {
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__hash_table(const hasher& __hf,
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__hash_table(const hasher& __hf,
                                                                const key_equal& __eql,
                                                                const allocator_type& __a)
                 : __bucket_list_(nullptr, __bucket_list_deleter(__pointer_allocator(__a), 0)),
@@ -1379,8 +3256,8 @@ struct __hash_value_type;
         {
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__hash_table(const allocator_type& __a)
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__hash_table(const allocator_type& __a)
                 : __bucket_list_(nullptr, __bucket_list_deleter(__pointer_allocator(__a), 0)),
                   __p1_(__node_allocator(__a)),
                   __p2_(0),
@@ -1388,9 +3265,10 @@ struct __hash_value_type;
         {
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__hash_table(const __hash_table& __u)
-                : __bucket_list_(nullptr,
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__hash_table(const __hash_table& __u)
+                : __bucket_options(__u),
+                  __bucket_list_(nullptr,
                                  __bucket_list_deleter(allocator_traits<__pointer_allocator>::
                                                        select_on_container_copy_construction(
                                          __u.__bucket_list_.get_deleter().__alloc()), 0)),
@@ -1401,10 +3279,11 @@ struct __hash_value_type;
         {
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__hash_table(const __hash_table& __u,
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__hash_table(const __hash_table& __u,
                                                                const allocator_type& __a)
-                : __bucket_list_(nullptr, __bucket_list_deleter(__pointer_allocator(__a), 0)),
+                : __bucket_options(__u),
+                  __bucket_list_(nullptr, __bucket_list_deleter(__pointer_allocator(__a), 0)),
                   __p1_(__node_allocator(__a)),
                   __p2_(0, __u.hash_function()),
                   __p3_(__u.__p3_)
@@ -1413,32 +3292,35 @@ struct __hash_value_type;
 
 #ifndef _LIBCPP_CXX03_LANG
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__hash_table(__hash_table&& __u)
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__hash_table(__hash_table&& __u)
         _NOEXCEPT_(
                 is_nothrow_move_constructible<__bucket_list>::value &&
                 is_nothrow_move_constructible<__first_node>::value &&
                 is_nothrow_move_constructible<__node_allocator>::value &&
                 is_nothrow_move_constructible<hasher>::value &&
                 is_nothrow_move_constructible<key_equal>::value)
-                : __bucket_list_(_VSTD::move(__u.__bucket_list_)),
+                : __bucket_options(__u),
+                  __bucket_list_(_VSTD::move(__u.__bucket_list_)),
                   __p1_(_VSTD::move(__u.__p1_)),
                   __p2_(_VSTD::move(__u.__p2_)),
                   __p3_(_VSTD::move(__u.__p3_))
         {
+            this->__take_order(__u);
             if (size() > 0)
             {
-                __bucket_list_[__constrain_hash(__p1_.first().__next_->__hash(), bucket_count())] =
+                __bucket_list_[__bucket_index(__node_hash(__p1_.first().__next_), bucket_count())] =
                         __p1_.first().__ptr();
                 __u.__p1_.first().__next_ = nullptr;
                 __u.size() = 0;
             }
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__hash_table(__hash_table&& __u,
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__hash_table(__hash_table&& __u,
                                                                const allocator_type& __a)
-                : __bucket_list_(nullptr, __bucket_list_deleter(__pointer_allocator(__a), 0)),
+                : __bucket_options(__u),
+                  __bucket_list_(nullptr, __bucket_list_deleter(__pointer_allocator(__a), 0)),
                   __p1_(__node_allocator(__a)),
                   __p2_(0, _VSTD::move(__u.hash_function())),
                   __p3_(_VSTD::move(__u.__p3_))
@@ -1446,53 +3328,54 @@ struct __hash_value_type;
             if (__a == allocator_type(__u.__node_alloc()))
             {
                 __bucket_list_.reset(__u.__bucket_list_.release());
-                __bucket_list_.get_deleter().size() = __u.__bucket_list_.get_deleter().size();
-                __u.__bucket_list_.get_deleter().size() = 0;
+                __bucket_list_.get_deleter().__take_array(__u.__bucket_list_.get_deleter());
                 if (__u.size() > 0)
                 {
                     __p1_.first().__next_ = __u.__p1_.first().__next_;
                     __u.__p1_.first().__next_ = nullptr;
-                    __bucket_list_[__constrain_hash(__p1_.first().__next_->__hash(), bucket_count())] =
+                    __bucket_list_[__bucket_index(__node_hash(__p1_.first().__next_), bucket_count())] =
                             __p1_.first().__ptr();
                     size() = __u.size();
                     __u.size() = 0;
+                    this->__take_nodes(__u);
                 }
             }
         }
 
 #endif  // _LIBCPP_CXX03_LANG
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::~__hash_table()
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::~__hash_table()
         {
             static_assert((is_copy_constructible<key_equal>::value),
                           "Predicate must be copy-constructible.");
             static_assert((is_copy_constructible<hasher>::value),
                           "Hasher must be copy-constructible.");
             __deallocate_node(__p1_.first().__next_);
+            __release_node_storage(__node_alloc());
 #if _LIBCPP_DEBUG_LEVEL >= 2
             __get_db()->__erase_c(this);
 #endif
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         void
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__copy_assign_alloc(
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__copy_assign_alloc(
                 const __hash_table& __u, true_type)
         {
             if (__node_alloc() != __u.__node_alloc())
             {
                 clear();
                 __bucket_list_.reset();
-                __bucket_list_.get_deleter().size() = 0;
+                __bucket_list_.get_deleter().__drop_array();
             }
             __bucket_list_.get_deleter().__alloc() = __u.__bucket_list_.get_deleter().__alloc();
             __node_alloc() = __u.__node_alloc();
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>&
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::operator=(const __hash_table& __u)
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>&
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::operator=(const __hash_table& __u)
         {
             if (this != &__u)
             {
@@ -1500,14 +3383,16 @@ struct __hash_value_type;
                 hash_function() = __u.hash_function();
                 key_eq() = __u.key_eq();
                 max_load_factor() = __u.max_load_factor();
+                static_cast<__bucket_options&>(*this) = __u;
+                __apply_fingerprint_setting();
                 __assign_multi(__u.begin(), __u.end());
             }
             return *this;
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         void
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__deallocate_node(__next_pointer __np)
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__deallocate_node(__next_pointer __np)
         _NOEXCEPT
         {
             __node_allocator& __na = __node_alloc();
@@ -1536,14 +3421,16 @@ struct __hash_value_type;
             }
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
-        typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::__next_pointer
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__detach() _NOEXCEPT
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__next_pointer
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__detach() _NOEXCEPT
         {
             size_type __bc = bucket_count();
             for (size_type __i = 0; __i < __bc; ++__i)
                 __bucket_list_[__i] = nullptr;
             size() = 0;
+            this->__drop_nodes();
+            __clear_fingerprints();
             __next_pointer __cache = __p1_.first().__next_;
             __p1_.first().__next_ = nullptr;
             return __cache;
@@ -1551,9 +3438,9 @@ struct __hash_value_type;
 
 #ifndef _LIBCPP_CXX03_LANG
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         void
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__move_assign(
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__move_assign(
                 __hash_table& __u, true_type)
         _NOEXCEPT_(
                 is_nothrow_move_assignable<__node_allocator>::value &&
@@ -1562,17 +3449,19 @@ struct __hash_value_type;
         {
             clear();
             __bucket_list_.reset(__u.__bucket_list_.release());
-            __bucket_list_.get_deleter().size() = __u.__bucket_list_.get_deleter().size();
-            __u.__bucket_list_.get_deleter().size() = 0;
+            __bucket_list_.get_deleter().__take_array(__u.__bucket_list_.get_deleter());
             __move_assign_alloc(__u);
             size() = __u.size();
             hash_function() = _VSTD::move(__u.hash_function());
             max_load_factor() = __u.max_load_factor();
             key_eq() = _VSTD::move(__u.key_eq());
             __p1_.first().__next_ = __u.__p1_.first().__next_;
+            this->__take_nodes(__u);
+            static_cast<__bucket_options&>(*this) = __u;
+            this->__note_change();
             if (size() > 0)
             {
-                __bucket_list_[__constrain_hash(__p1_.first().__next_->__hash(), bucket_count())] =
+                __bucket_list_[__bucket_index(__node_hash(__p1_.first().__next_), bucket_count())] =
                         __p1_.first().__ptr();
                 __u.__p1_.first().__next_ = nullptr;
                 __u.size() = 0;
@@ -1582,9 +3471,9 @@ struct __hash_value_type;
 #endif
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         void
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__move_assign(
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__move_assign(
                 __hash_table& __u, false_type)
         {
             if (__node_alloc() == __u.__node_alloc())
@@ -1594,6 +3483,8 @@ struct __hash_value_type;
                 hash_function() = _VSTD::move(__u.hash_function());
                 key_eq() = _VSTD::move(__u.key_eq());
                 max_load_factor() = __u.max_load_factor();
+                static_cast<__bucket_options&>(*this) = __u;
+                __apply_fingerprint_setting();
                 if (bucket_count() != 0)
                 {
                     __next_pointer __cache = __detach();
@@ -1630,10 +3521,10 @@ struct __hash_value_type;
             }
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         inline
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>&
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::operator=(__hash_table&& __u)
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>&
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::operator=(__hash_table&& __u)
         _NOEXCEPT_(
                 __node_traits::propagate_on_container_move_assignment::value &&
                 is_nothrow_move_assignable<__node_allocator>::value &&
@@ -1647,10 +3538,10 @@ struct __hash_value_type;
 
 #endif  // _LIBCPP_CXX03_LANG
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         template <class _InputIterator>
         void
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__assign_unique(_InputIterator __first,
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__assign_unique(_InputIterator __first,
                                                                   _InputIterator __last)
         {
             typedef iterator_traits<_InputIterator> _ITraits;
@@ -1686,10 +3577,10 @@ struct __hash_value_type;
                 __insert_unique(*__first);
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         template <class _InputIterator>
         void
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__assign_multi(_InputIterator __first,
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__assign_multi(_InputIterator __first,
                                                                  _InputIterator __last)
         {
             typedef iterator_traits<_InputIterator> _ITraits;
@@ -1726,10 +3617,10 @@ struct __hash_value_type;
                 __insert_multi(_NodeTypes::__get_value(*__first));
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         inline
-        typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::iterator
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::begin() _NOEXCEPT
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::iterator
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::begin() _NOEXCEPT
         {
 #if _LIBCPP_DEBUG_LEVEL >= 2
             return iterator(__p1_.first().__next_, this);
@@ -1739,51 +3630,652 @@ struct __hash_value_type;
         }
 
         // START ADDED CODE
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         inline
-        typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::iterator
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::begin_random() _NOEXCEPT
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::iterator
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::begin_random() _NOEXCEPT
         {
-#if _LIBCPP_DEBUG_LEVEL >= 2
-            return iterator(__p1_.first().__next_, this);
-#else
-            vector <iterator> vect;
-            iterator it_current, it_prev, it_init;
-            int index;
+            if (this->__shuffle_stands())
+                return begin();
+            return reshuffle();
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        inline
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::iterator
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::reshuffle() _NOEXCEPT
+        {
+            static_assert(__order_traits::__shuffles::value,
+                          "reshuffle() needs a shuffling iteration order; "
+                          "ordered_iteration tables have no generator, use begin_random(g)");
+            return begin_random(static_cast<__hash_rng&>(this->__rng()));
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        template <class _URBG>
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::iterator
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::begin_random(_URBG&& __g)
+        {
+#if !defined(_LIBCPP_CXX03_LANG) && !defined(_LIBCPP_HAS_NO_THREADS)
+            const __hash_shuffle_options& __opt = this->__shuffle_options();
+            unsigned __nt = __opt.__threads_;
+            if (__nt == 0)
+                __nt = thread::hardware_concurrency();
+            if (size() >= __opt.__parallel_threshold_ && __nt > 1)
+            {
+#ifndef _LIBCPP_NO_EXCEPTIONS
+                // __shuffle_parallel does all of its allocation before it
+                // touches the chain, so running out of memory leaves the table
+                // as it was and a serial shuffle can take over.
+                try
+                {
+#endif  // _LIBCPP_NO_EXCEPTIONS
+                    __shuffle_parallel(__g, __nt);
+                    this->__note_shuffle();
+                    return begin();
+#ifndef _LIBCPP_NO_EXCEPTIONS
+                }
+                catch (const bad_alloc&)
+                {
+                }
+#endif  // _LIBCPP_NO_EXCEPTIONS
+            }
+#endif
+            if (!__opt.__in_place_)
+            {
+#ifndef _LIBCPP_NO_EXCEPTIONS
+                // Likewise __shuffle_relink: if its index cannot be had, the
+                // in-place shuffle needs no memory at all.
+                try
+                {
+#endif  // _LIBCPP_NO_EXCEPTIONS
+                    __shuffle_relink(__g);
+                    this->__note_shuffle();
+                    return begin();
+#ifndef _LIBCPP_NO_EXCEPTIONS
+                }
+                catch (const bad_alloc&)
+                {
+                }
+#endif  // _LIBCPP_NO_EXCEPTIONS
+            }
+            __shuffle_in_place(__g);
+            this->__note_shuffle();
+            return begin();
+        }
+
+        // Returns the last node of the unit of kind __u that starts at __np.
+        // Equal keys have equal hashes, so the key comparison only runs when
+        // the cached hashes already match.
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        inline
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__next_pointer
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__unit_last(__next_pointer __np,
+                                                                      __shuffle_unit __u,
+                                                                      size_type __bc) const
+        {
+            if (__u == __key_unit)
+            {
+                while (__np->__next_ != nullptr &&
+                       __node_hash(__np->__next_) == __node_hash(__np) &&
+                       key_eq()(__np->__next_->__upcast()->__value_, __np->__upcast()->__value_))
+                    __np = __np->__next_;
+            }
+            else if (__u == __bucket_unit)
+            {
+                size_t __chash = __bucket_index(__node_hash(__np), __bc);
+                while (__np->__next_ != nullptr &&
+                       __bucket_index(__node_hash(__np->__next_), __bc) == __chash)
+                    __np = __np->__next_;
+            }
+            return __np;
+        }
+
+        // Shuffles the first __n units linked from __h. Returns the first node
+        // of the result and sets __last to its last node and __rest to the node
+        // that followed the __n units; __last->__next_ is left unspecified.
+        // Each half is shuffled recursively and the halves are merged by taking
+        // the next unit from a side with probability proportional to the units
+        // it has left, which makes every order equally likely. Extra space is
+        // the O(log __n) recursion.
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        template <class _URBG>
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__next_pointer
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__merge_shuffle(__next_pointer __h, size_type __n,
+                                                                  __shuffle_unit __u, size_type __bc,
+                                                                  _URBG& __g, __next_pointer& __last,
+                                                                  __next_pointer& __rest) const
+        {
+            if (__n == 1)
+            {
+                __last = __unit_last(__h, __u, __bc);
+                __rest = __last->__next_;
+                return __h;
+            }
+            size_type __na = __n / 2;
+            size_type __nb = __n - __na;
+            __next_pointer __la;
+            __next_pointer __lb;
+            __next_pointer __pa = __merge_shuffle(__h, __na, __u, __bc, __g, __la, __rest);
+            __next_pointer __pb = __merge_shuffle(__rest, __nb, __u, __bc, __g, __lb, __rest);
+            __next_pointer __first = nullptr;
+            __next_pointer __tail = nullptr;
+            while (__na != 0 && __nb != 0)
+            {
+                __next_pointer __np;
+                __next_pointer __nl;
+                if (__hash_uniform(__g, __na + __nb) < __na)
+                {
+                    __np = __pa;
+                    __nl = --__na != 0 ? __unit_last(__np, __u, __bc) : __la;
+                    __pa = __nl->__next_;
+                }
+                else
+                {
+                    __np = __pb;
+                    __nl = --__nb != 0 ? __unit_last(__np, __u, __bc) : __lb;
+                    __pb = __nl->__next_;
+                }
+                if (__tail != nullptr)
+                    __tail->__next_ = __np;
+                else
+                    __first = __np;
+                __tail = __nl;
+            }
+            if (__na != 0)
+            {
+                __tail->__next_ = __pa;
+                __last = __la;
+            }
+            else
+            {
+                __tail->__next_ = __pb;
+                __last = __lb;
+            }
+            return __first;
+        }
+
+        // Shuffles one bucket run of __n nodes linked from __h and returns its
+        // first node, setting __last to its last one. Nodes are shuffled within
+        // each run of equal keys and then the key runs are shuffled, so equal
+        // keys stay adjacent for __equal_range_multi, __count_multi and the
+        // group scan in __rehash.
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        template <class _URBG>
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__next_pointer
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__shuffle_run(__next_pointer __h, size_type __n,
+                                                                _URBG& __g,
+                                                                __next_pointer& __last) const
+        {
+            __next_pointer __first = __h;
+            __next_pointer __prev = nullptr;
+            size_type __ng = 0;
+            while (__n != 0)
+            {
+                __next_pointer __ge = __h;
+                size_type __k = 1;
+                while (__k < __n && __node_hash(__ge->__next_) == __node_hash(__h) &&
+                       key_eq()(__ge->__next_->__upcast()->__value_, __h->__upcast()->__value_))
+                {
+                    __ge = __ge->__next_;
+                    ++__k;
+                }
+                __next_pointer __after = __ge->__next_;
+                if (__k > 1)
+                {
+                    __next_pointer __rest;
+                    __h = __merge_shuffle(__h, __k, __node_unit, 0, __g, __ge, __rest);
+                    if (__prev != nullptr)
+                        __prev->__next_ = __h;
+                    else
+                        __first = __h;
+                    __ge->__next_ = __after;
+                }
+                __prev = __ge;
+                __h = __after;
+                __n -= __k;
+                ++__ng;
+            }
+            __last = __prev;
+            if (__ng > 1)
+            {
+                __next_pointer __rest;
+                __first = __merge_shuffle(__first, __ng, __key_unit, 0, __g, __last, __rest);
+            }
+            return __first;
+        }
+
+        // Every bucket's nodes must stay contiguous in the chain and
+        // __bucket_list_[__b] must point at the node just before them, otherwise
+        // lookups walk past their bucket. So each bucket run is shuffled first
+        // (see __shuffle_run), then the runs themselves, and a last pass points
+        // every bucket slot at its run's new predecessor. Nothing is allocated.
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        template <class _URBG>
+        void
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__shuffle_in_place(_URBG& __g)
+        {
+            if (size() < 2)
+                return;
+            size_type __bc = bucket_count();
+            __next_pointer __pp = __p1_.first().__ptr();
+            size_type __nr = 0;
+            while (__pp->__next_ != nullptr)
+            {
+                __next_pointer __rb = __pp->__next_;
+                __next_pointer __re = __rb;
+                size_type __m = 1;
+                size_t __chash = __bucket_index(__node_hash(__rb), __bc);
+                while (__re->__next_ != nullptr &&
+                       __bucket_index(__node_hash(__re->__next_), __bc) == __chash)
+                {
+                    __re = __re->__next_;
+                    ++__m;
+                }
+                if (__m > 1)
+                {
+                    __next_pointer __after = __re->__next_;
+                    __pp->__next_ = __shuffle_run(__rb, __m, __g, __re);
+                    __re->__next_ = __after;
+                }
+                __pp = __re;
+                ++__nr;
+            }
+            if (__nr > 1)
+            {
+                __next_pointer __last;
+                __next_pointer __rest;
+                __p1_.first().__next_ = __merge_shuffle(__p1_.first().__next_, __nr, __bucket_unit,
+                                                        __bc, __g, __last, __rest);
+                __last->__next_ = nullptr;
+            }
+            __pp = __p1_.first().__ptr();
+            size_t __phash = __bc;
+            for (__next_pointer __cp = __pp->__next_; __cp != nullptr; __cp = __cp->__next_)
+            {
+                size_t __chash = __bucket_index(__node_hash(__cp), __bc);
+                if (__chash != __phash)
+                {
+                    __bucket_list_[__chash] = __pp;
+                    __phash = __chash;
+                }
+                __pp = __cp;
+            }
+        }
+
+        // The default serial shuffle, in linear time: the bucket runs are
+        // indexed, put in Fisher-Yates order, and relinked one after another,
+        // each shuffled by __shuffle_run on the way. The index is built before
+        // the chain is touched, so a bad_alloc leaves the table as it was.
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        template <class _URBG>
+        void
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__shuffle_relink(_URBG& __g)
+        {
+            if (size() < 2)
+                return;
+            size_type __bc = bucket_count();
+            vector<__next_pointer> __nodes;
+            vector<pair<size_type, size_type> > __runs;
+            __collect_bucket_runs(__nodes, __runs);
+            size_type __nr = __runs.size();
+            __next_pointer __pp = __p1_.first().__ptr();
+            for (size_type __i = 0; __i < __nr; ++__i)
+            {
+                _VSTD::swap(__runs[__i], __runs[__i + __hash_uniform(__g, __nr - __i)]);
+                size_type __rb = __runs[__i].first;
+                __next_pointer __rl;
+                __next_pointer __rf = __shuffle_run(__nodes[__rb], __runs[__i].second - __rb,
+                                                    __g, __rl);
+                __bucket_list_[__bucket_index(__node_hash(__rf), __bc)] = __pp;
+                __pp->__next_ = __rf;
+                __pp = __rl;
+            }
+            __pp->__next_ = nullptr;
+        }
+
+        // Copies the chain into __nodes and records each bucket's [first, last)
+        // range of positions in __runs, in chain order.
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        void
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__collect_bucket_runs(
+                vector<__next_pointer>& __nodes, vector<pair<size_type, size_type> >& __runs) const
+        {
+            size_type __n = size();
+            size_type __bc = bucket_count();
+            __nodes.reserve(__n);
+            size_t __phash = __bc;
+            for (__next_pointer __np = __p1_.first().__next_; __np != nullptr; __np = __np->__next_)
+            {
+                size_t __chash = __bucket_index(__node_hash(__np), __bc);
+                if (__chash != __phash)
+                {
+                    if (!__runs.empty())
+                        __runs.back().second = __nodes.size();
+                    __runs.push_back(pair<size_type, size_type>(__nodes.size(), __n));
+                    __phash = __chash;
+                }
+                __nodes.push_back(__np);
+            }
+        }
+
+#if !defined(_LIBCPP_CXX03_LANG) && !defined(_LIBCPP_HAS_NO_THREADS)
+        // Runs __f(0) ... __f(__nt - 1), each on its own thread where one can be
+        // started and on the calling thread otherwise.
+        template <class _Fp>
+        void
+        __hash_parallel_for(unsigned __nt, _Fp __f)
+        {
+            vector<thread> __ts;
+            __ts.reserve(__nt);
+            unsigned __i = 1;
+#ifndef _LIBCPP_NO_EXCEPTIONS
+            try
+            {
+#endif  // _LIBCPP_NO_EXCEPTIONS
+                for (; __i < __nt; ++__i)
+                    __ts.push_back(thread(__f, __i));
+#ifndef _LIBCPP_NO_EXCEPTIONS
+            }
+            catch (...)
+            {
+            }
+#endif  // _LIBCPP_NO_EXCEPTIONS
+            for (unsigned __j = __i; __j < __nt; ++__j)
+                __f(__j);
+            __f(0);
+            for (size_t __j = 0; __j < __ts.size(); ++__j)
+                __ts[__j].join();
+        }
+
+        // Same distribution as the serial shuffle, split over __nt threads:
+        // every bucket run is dealt to one of __nt bins uniformly at random, the
+        // bins are shuffled and linked concurrently, and the bins are then
+        // joined in order. A multinomial deal followed by independent uniform
+        // shuffles of the bins yields a uniform permutation of the runs.
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        template <class _URBG>
+        void
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__shuffle_parallel(_URBG& __g, unsigned __nt)
+        {
+            size_type __bc = bucket_count();
+            vector<__next_pointer> __nodes;
+            vector<pair<size_type, size_type> > __runs;
+            __collect_bucket_runs(__nodes, __runs);
+            size_type __nr = __runs.size();
+
+            // One generator per thread: a common seed from __g, a stream each.
+            vector<__hash_rng> __engines;
+            __engines.reserve(__nt);
+            uint64_t __seed = uniform_int_distribution<uint64_t>()(__g);
+            for (unsigned __t = 0; __t < __nt; ++__t)
+                __engines.push_back(__hash_rng(__seed, __t));
+
+            // Deal: thread __t bins the runs of its slice and counts per bin.
+            vector<unsigned> __bin(__nr);
+            vector<size_type> __count(__nt * __nt, 0);
+            __hash_parallel_for(__nt, [&](unsigned __t)
+            {
+                for (size_type __i = __nr * __t / __nt; __i < __nr * (__t + 1) / __nt; ++__i)
+                {
+                    __bin[__i] = static_cast<unsigned>(__hash_uniform(__engines[__t], __nt));
+                    ++__count[__t * __nt + __bin[__i]];
+                }
+            });
+            vector<size_type> __bin_begin(__nt + 1);
+            size_type __off = 0;
+            for (unsigned __b = 0; __b < __nt; ++__b)
+            {
+                __bin_begin[__b] = __off;
+                for (unsigned __t = 0; __t < __nt; ++__t)
+                {
+                    size_type __c = __count[__t * __nt + __b];
+                    __count[__t * __nt + __b] = __off;
+                    __off += __c;
+                }
+            }
+            __bin_begin[__nt] = __nr;
+            vector<pair<size_type, size_type> > __dealt(__nr);
+            __hash_parallel_for(__nt, [&](unsigned __t)
+            {
+                for (size_type __i = __nr * __t / __nt; __i < __nr * (__t + 1) / __nt; ++__i)
+                    __dealt[__count[__t * __nt + __bin[__i]]++] = __runs[__i];
+            });
+
+            // Shuffle and link each bin. A bin's first run gets its bucket head
+            // once the bins are joined; every other bucket slot is written by
+            // the one thread that owns the run.
+            vector<__next_pointer> __first(__nt, nullptr);
+            vector<__next_pointer> __last(__nt, nullptr);
+            __hash_parallel_for(__nt, [&](unsigned __b)
+            {
+                __hash_rng& __e = __engines[__b];
+                size_type __hi = __bin_begin[__b + 1];
+                __next_pointer __pp = nullptr;
+                for (size_type __i = __bin_begin[__b]; __i < __hi; ++__i)
+                {
+                    _VSTD::swap(__dealt[__i], __dealt[__i + __hash_uniform(__e, __hi - __i)]);
+                    size_type __rb = __dealt[__i].first;
+                    __next_pointer __rl;
+                    __next_pointer __rf = __shuffle_run(__nodes[__rb], __dealt[__i].second - __rb,
+                                                        __e, __rl);
+                    if (__pp != nullptr)
+                    {
+                        __bucket_list_[__bucket_index(__node_hash(__rf), __bc)] = __pp;
+                        __pp->__next_ = __rf;
+                    }
+                    else
+                        __first[__b] = __rf;
+                    __pp = __rl;
+                }
+                __last[__b] = __pp;
+            });
+
+            __next_pointer __pp = __p1_.first().__ptr();
+            for (unsigned __b = 0; __b < __nt; ++__b)
+            {
+                if (__first[__b] == nullptr)
+                    continue;
+                __pp->__next_ = __first[__b];
+                __bucket_list_[__bucket_index(__node_hash(__first[__b]), __bc)] = __pp;
+                __pp = __last[__b];
+            }
+            __pp->__next_ = nullptr;
+        }
+#endif  // !defined(_LIBCPP_CXX03_LANG) && !defined(_LIBCPP_HAS_NO_THREADS)
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        template <class _URBG>
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::random_iterator
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::random_begin(_URBG&& __g) const
+        {
+            if (size() == 0)
+                return random_end();
+            uniform_int_distribution<size_t> __d;
+            size_t __seed[4];
+            for (int __i = 0; __i < 4; ++__i)
+                __seed[__i] = __d(__g);
+            return random_iterator(__bucket_list_.get(), bucket_count(),
+                                   __bucket_list_.get_deleter().__reciprocal(), __seed, __hash_source(hash_function()));
+        }
 
-            // insert elements from hash table into vector
-            for (iterator it(__p1_.first().__next_); it != nullptr; it++){
-                vect.push_back(static_cast<iterator&&>(it));
+        // Rejection sampling over (bucket, position) pairs: a uniformly drawn
+        // bucket and a position below __bound, at least the longest bucket,
+        // name a node with probability 1 / (bucket_count() * __bound) whatever the
+        // bucket's length, and empty positions are redrawn. At a normal load
+        // factor the expected number of draws is a small constant.
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        template <class _URBG>
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__next_pointer
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__random_node(_URBG& __g,
+                                                                       size_type __bound) const
+        {
+            if (size() == 0)
+                return nullptr;
+            size_type __bc = bucket_count();
+            _LIBCPP_ASSERT(__bound > 0,
+                           "__random_node: a non-empty table must have a bucket size bound");
+            uniform_int_distribution<size_type> __db(0, __bc - 1);
+            uniform_int_distribution<size_type> __dp(0, __bound - 1);
+            while (true)
+            {
+                size_type __b = __db(__g);
+                __next_pointer __np = __bucket_list_[__b];
+                if (__np == nullptr)
+                    continue;
+                size_type __j = __dp(__g);
+                for (__np = __np->__next_; __np != nullptr &&
+                                           __bucket_index(__node_hash(__np), __bc) == __b;
+                     __np = __np->__next_, --__j)
+                {
+                    if (__j == 0)
+                        return __np;
+                }
             }
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        template <class _URBG>
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::const_iterator
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__random_element(_URBG&& __g) const
+        {
+#if _LIBCPP_DEBUG_LEVEL >= 2
+            return const_iterator(__random_node(__g, __sampling_bound()), this);
+#else
+            return const_iterator(__random_node(__g, __sampling_bound()));
+#endif
+        }
 
-            // shuffle elements and insert them into the new hash table
-            index = rand() % vect.size();
-            it_init = vect[index];
-            it_prev = it_init;
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        template <class _URBG, class _OutputIterator>
+        _OutputIterator
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__sample(size_type __k, _URBG&& __g,
+                                                           _OutputIterator __out) const
+        {
+            if (size() == 0)
+                return __out;
+            size_type __bound = __sampling_bound();
+            for (; __k > 0; --__k, ++__out)
+                *__out = __random_node(__g, __bound)->__upcast()->__value_;
+            return __out;
+        }
 
-            vect.erase(vect.begin()+index);
-            while (!vect.empty()) {
-                index = rand() % vect.size();
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::size_type
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__longest_bucket() const _NOEXCEPT
+        {
+            size_type __bc = bucket_count();
+            size_type __m = 0;
+            size_type __s = 0;
+            size_t __phash = __bc;
+            for (__next_pointer __np = __p1_.first().__next_; __np != nullptr; __np = __np->__next_)
+            {
+                size_t __chash = __bucket_index(__node_hash(__np), __bc);
+                if (__chash != __phash)
+                {
+                    __s = 0;
+                    __phash = __chash;
+                }
+                if (++__s > __m)
+                    __m = __s;
+            }
+            return __m;
+        }
 
-                it_current = vect[index];
-                it_prev.setNext(it_current);
-                it_prev = it_current;
+        // Recomputes bucket __chash's fingerprint after a node left it, so
+        // erasures do not leave stale bits behind.
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        void
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__refresh_fingerprint(size_t __chash) _NOEXCEPT
+        {
+            unsigned char* __fp = __fingerprints();
+            if (__fp == nullptr)
+                return;
+            size_type __bc = bucket_count();
+            unsigned char __f = 0;
+            __next_pointer __np = __bucket_list_[__chash];
+            if (__np != nullptr)
+                for (__np = __np->__next_;
+                     __np != nullptr && __bucket_index(__node_hash(__np), __bc) == __chash;
+                     __np = __np->__next_)
+                    __f |= __fingerprint(__node_hash(__np));
+            __fp[__chash] = __f;
+        }
 
-                vect.erase(vect.begin() + index);
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        void
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__fill_fingerprints() _NOEXCEPT
+        {
+            unsigned char* __f = __fingerprints();
+            if (__f == nullptr)
+                return;
+            size_type __bc = bucket_count();
+            _VSTD::fill(__f, __f + __bc, 0);
+            for (__next_pointer __np = __p1_.first().__next_; __np != nullptr; __np = __np->__next_)
+            {
+                size_t __h = __node_hash(__np);
+                __f[__bucket_index(__h, __bc)] |= __fingerprint(__h);
             }
-            it_prev.setNext(iterator(nullptr));
+        }
 
-            __p1_.first().__next_ = it_init.getNode();
-            it_init = iterator(__p1_.first().__next_);
-            return it_init;
+#ifndef _LIBCPP_CXX03_LANG
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        template <class _URBG>
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::template lazy_random_iterator<_URBG>
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::lazy_random_begin(_URBG& __g) const
+        {
+            if (size() == 0)
+                return lazy_random_end<_URBG>();
+            return lazy_random_iterator<_URBG>(this, _VSTD::addressof(__g), __sampling_bound(),
+                                               __size_allocator(__node_alloc()));
+        }
 #endif
+
+        // One step of an inside-out Fisher-Yates over the grid of
+        // bucket_count() x __bound cells used by __random_node, __bound being
+        // taken when the iteration began. Only displaced cells are stored, in
+        // __m. Cells that do not hold a node are skipped, so a node costs
+        // bucket_count() * __bound / size() draws on average, and __m gains at
+        // most one entry per draw; the nodes still come out in a uniformly
+        // random order and each exactly once.
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        template <class _URBG>
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__next_pointer
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__lazy_random_next(
+                size_type& __pos, size_type __bound, __hash_swap_map<size_type, __size_allocator>& __m,
+                _URBG& __g) const
+        {
+            size_type __bc = bucket_count();
+            size_type __cells = __bc * __bound;
+            while (__pos < __cells)
+            {
+                uniform_int_distribution<size_type> __d(__pos, __cells - 1);
+                size_type __r = __d(__g);
+                size_type __v = __m.__get(__r);
+                if (__r != __pos)
+                    __m.__put(__r, __m.__get(__pos));
+                ++__pos;
+                size_type __b = __v / __bound;
+                size_type __j = __v % __bound;
+                __next_pointer __np = __bucket_list_[__b];
+                if (__np == nullptr)
+                    continue;
+                for (__np = __np->__next_; __np != nullptr &&
+                                           __bucket_index(__node_hash(__np), __bc) == __b;
+                     __np = __np->__next_, --__j)
+                {
+                    if (__j == 0)
+                        return __np;
+                }
+            }
+            return nullptr;
         }
         // END CODE
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         inline
-        typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::iterator
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::end() _NOEXCEPT
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::iterator
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::end() _NOEXCEPT
         {
 #if _LIBCPP_DEBUG_LEVEL >= 2
             return iterator(nullptr, this);
@@ -1792,10 +4284,10 @@ struct __hash_value_type;
 #endif
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         inline
-        typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::const_iterator
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::begin() const _NOEXCEPT
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::const_iterator
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::begin() const _NOEXCEPT
         {
 #if _LIBCPP_DEBUG_LEVEL >= 2
             return const_iterator(__p1_.first().__next_, this);
@@ -1804,10 +4296,10 @@ struct __hash_value_type;
 #endif
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         inline
-        typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::const_iterator
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::end() const _NOEXCEPT
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::const_iterator
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::end() const _NOEXCEPT
         {
 #if _LIBCPP_DEBUG_LEVEL >= 2
             return const_iterator(nullptr, this);
@@ -1816,9 +4308,9 @@ struct __hash_value_type;
 #endif
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         void
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::clear() _NOEXCEPT
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::clear() _NOEXCEPT
         {
             if (size() > 0)
             {
@@ -1828,27 +4320,35 @@ struct __hash_value_type;
                 for (size_type __i = 0; __i < __bc; ++__i)
                     __bucket_list_[__i] = nullptr;
                 size() = 0;
+                this->__drop_nodes();
+                __clear_fingerprints();
+                __release_node_storage(__node_alloc());
             }
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
-        pair<typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::iterator, bool>
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__node_insert_unique(__node_pointer __nd)
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        pair<typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::iterator, bool>
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__node_insert_unique(__node_pointer __nd)
         {
-            __nd->__hash_ = hash_function()(__nd->__value_);
+            size_t __hash = hash_function()(__nd->__value_);
+            __set_node_hash(__nd, __hash);
             size_type __bc = bucket_count();
             bool __inserted = false;
             __next_pointer __ndptr;
             size_t __chash;
+            // Length of bucket __chash if the lookup saw all of it, else -1.
+            size_type __len = size_type(-1);
             if (__bc != 0)
             {
-                __chash = __constrain_hash(__nd->__hash_, __bc);
+                __chash = __bucket_index(__hash, __bc);
                 __ndptr = __bucket_list_[__chash];
-                if (__ndptr != nullptr)
+                if (__ndptr == nullptr)
+                    __len = 0;
+                else if (!__fingerprint_rejects(__chash, __hash))
                 {
-                    for (__ndptr = __ndptr->__next_; __ndptr != nullptr &&
-                                                     __constrain_hash(__ndptr->__hash(), __bc) == __chash;
-                         __ndptr = __ndptr->__next_)
+                    for (__len = 0, __ndptr = __ndptr->__next_; __ndptr != nullptr &&
+                                                     __bucket_index(__node_hash(__ndptr), __bc) == __chash;
+                         __ndptr = __ndptr->__next_, ++__len)
                     {
                         if (key_eq()(__ndptr->__upcast()->__value_, __nd->__value_))
                             goto __done;
@@ -1861,7 +4361,8 @@ struct __hash_value_type;
                     rehash(_VSTD::max<size_type>(2 * __bc + !__is_hash_power2(__bc),
                                                  size_type(ceil(float(size() + 1) / max_load_factor()))));
                     __bc = bucket_count();
-                    __chash = __constrain_hash(__nd->__hash_, __bc);
+                    __chash = __bucket_index(__hash, __bc);
+                    __len = size_type(-1);
                 }
                 // insert_after __bucket_list_[__chash], or __first_node if bucket is null
                 __next_pointer __pn = __bucket_list_[__chash];
@@ -1873,7 +4374,7 @@ struct __hash_value_type;
                     // fix up __bucket_list_
                     __bucket_list_[__chash] = __pn;
                     if (__nd->__next_ != nullptr)
-                        __bucket_list_[__constrain_hash(__nd->__next_->__hash(), __bc)] = __nd->__ptr();
+                        __bucket_list_[__bucket_index(__node_hash(__nd->__next_), __bc)] = __nd->__ptr();
                 }
                 else
                 {
@@ -1883,6 +4384,12 @@ struct __hash_value_type;
                 __ndptr = __nd->__ptr();
                 // increment size
                 ++size();
+                if (__len != size_type(-1))
+                    __note_bucket_size(__len + 1, nullptr, __chash, __bc);
+                else
+                    __note_bucket_size(0, __ndptr, __chash, __bc);
+                __fingerprint_add(__chash, __hash);
+                this->__note_change();
                 __inserted = true;
             }
             __done:
@@ -1893,11 +4400,12 @@ struct __hash_value_type;
 #endif
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
-        typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::iterator
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__node_insert_multi(__node_pointer __cp)
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::iterator
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__node_insert_multi(__node_pointer __cp,
+                                                                             size_t __hash)
         {
-            __cp->__hash_ = hash_function()(__cp->__value_);
+            __set_node_hash(__cp, __hash);
             size_type __bc = bucket_count();
             if (size()+1 > __bc * max_load_factor() || __bc == 0)
             {
@@ -1905,8 +4413,12 @@ struct __hash_value_type;
                                              size_type(ceil(float(size() + 1) / max_load_factor()))));
                 __bc = bucket_count();
             }
-            size_t __chash = __constrain_hash(__cp->__hash_, __bc);
+            size_t __chash = __bucket_index(__hash, __bc);
             __next_pointer __pn = __bucket_list_[__chash];
+            // New length of bucket __chash: the node, those the search for its
+            // place passed and the rest of the bucket after it, from __rest.
+            size_type __len = 1;
+            __next_pointer __rest = nullptr;
             if (__pn == nullptr)
             {
                 __pn =__p1_.first().__ptr();
@@ -1915,21 +4427,21 @@ struct __hash_value_type;
                 // fix up __bucket_list_
                 __bucket_list_[__chash] = __pn;
                 if (__cp->__next_ != nullptr)
-                    __bucket_list_[__constrain_hash(__cp->__next_->__hash(), __bc)]
+                    __bucket_list_[__bucket_index(__node_hash(__cp->__next_), __bc)]
                             = __cp->__ptr();
             }
             else
             {
                 for (bool __found = false; __pn->__next_ != nullptr &&
-                                           __constrain_hash(__pn->__next_->__hash(), __bc) == __chash;
-                     __pn = __pn->__next_)
+                                           __bucket_index(__node_hash(__pn->__next_), __bc) == __chash;
+                     __pn = __pn->__next_, ++__len)
                 {
                     //      __found    key_eq()     action
                     //      false       false       loop
                     //      true        true        loop
                     //      false       true        set __found to true
                     //      true        false       break
-                    if (__found != (__pn->__next_->__hash() == __cp->__hash_ &&
+                    if (__found != (__node_hash(__pn->__next_) == __hash &&
                                     key_eq()(__pn->__next_->__upcast()->__value_, __cp->__value_)))
                     {
                         if (!__found)
@@ -1942,12 +4454,17 @@ struct __hash_value_type;
                 __pn->__next_ = __cp->__ptr();
                 if (__cp->__next_ != nullptr)
                 {
-                    size_t __nhash = __constrain_hash(__cp->__next_->__hash(), __bc);
+                    size_t __nhash = __bucket_index(__node_hash(__cp->__next_), __bc);
                     if (__nhash != __chash)
                         __bucket_list_[__nhash] = __cp->__ptr();
+                    else
+                        __rest = __cp->__next_;
                 }
             }
             ++size();
+            __note_bucket_size(__len, __rest, __chash, __bc);
+            __fingerprint_add(__chash, __hash);
+            this->__note_change();
 #if _LIBCPP_DEBUG_LEVEL >= 2
             return iterator(__cp->__ptr(), this);
 #else
@@ -1955,9 +4472,9 @@ struct __hash_value_type;
 #endif
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
-        typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::iterator
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__node_insert_multi(
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::iterator
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__node_insert_multi(
                 const_iterator __p, __node_pointer __cp)
         {
 #if _LIBCPP_DEBUG_LEVEL >= 2
@@ -1968,7 +4485,8 @@ struct __hash_value_type;
             if (__p != end() && key_eq()(*__p, __cp->__value_))
             {
                 __next_pointer __np = __p.__node_;
-                __cp->__hash_ = __np->__hash();
+                size_t __hash = __node_hash(__np);
+                __set_node_hash(__cp, __hash);
                 size_type __bc = bucket_count();
                 if (size()+1 > __bc * max_load_factor() || __bc == 0)
                 {
@@ -1976,13 +4494,20 @@ struct __hash_value_type;
                                                  size_type(ceil(float(size() + 1) / max_load_factor()))));
                     __bc = bucket_count();
                 }
-                size_t __chash = __constrain_hash(__cp->__hash_, __bc);
+                size_t __chash = __bucket_index(__hash, __bc);
                 __next_pointer __pp = __bucket_list_[__chash];
+                size_type __len = 1;
                 while (__pp->__next_ != __np)
+                {
                     __pp = __pp->__next_;
+                    ++__len;
+                }
                 __cp->__next_ = __np;
                 __pp->__next_ = static_cast<__next_pointer>(__cp);
                 ++size();
+                __note_bucket_size(__len, __np, __chash, __bc);
+                __fingerprint_add(__chash, __hash);
+                this->__note_change();
 #if _LIBCPP_DEBUG_LEVEL >= 2
                 return iterator(static_cast<__next_pointer>(__cp), this);
 #else
@@ -1995,32 +4520,36 @@ struct __hash_value_type;
 
 
 #ifndef _LIBCPP_CXX03_LANG
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         template <class _Key, class ..._Args>
-        pair<typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::iterator, bool>
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__emplace_unique_key_args(_Key const& __k, _Args&&... __args)
+        pair<typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::iterator, bool>
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__emplace_unique_hashed(size_t __hash, _Key const& __k,
+                                                                                  _Args&&... __args)
 #else
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
 template <class _Key, class _Args>
-pair<typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::iterator, bool>
-__hash_table<_Tp, _Hash, _Equal, _Alloc>::__emplace_unique_key_args(_Key const& __k, _Args& __args)
+pair<typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::iterator, bool>
+__hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__emplace_unique_hashed(size_t __hash, _Key const& __k,
+                                                                          _Args& __args)
 #endif
         {
-
-            size_t __hash = hash_function()(__k);
             size_type __bc = bucket_count();
             bool __inserted = false;
             __next_pointer __nd;
             size_t __chash;
+            // Length of bucket __chash if the lookup saw all of it, else -1.
+            size_type __len = size_type(-1);
             if (__bc != 0)
             {
-                __chash = __constrain_hash(__hash, __bc);
+                __chash = __bucket_index(__hash, __bc);
                 __nd = __bucket_list_[__chash];
-                if (__nd != nullptr)
+                if (__nd == nullptr)
+                    __len = 0;
+                else if (!__fingerprint_rejects(__chash, __hash))
                 {
-                    for (__nd = __nd->__next_; __nd != nullptr &&
-                                               (__nd->__hash() == __hash || __constrain_hash(__nd->__hash(), __bc) == __chash);
-                         __nd = __nd->__next_)
+                    for (__len = 0, __nd = __nd->__next_; __nd != nullptr &&
+                                               (__node_hash(__nd) == __hash || __bucket_index(__node_hash(__nd), __bc) == __chash);
+                         __nd = __nd->__next_, ++__len)
                     {
                         if (key_eq()(__nd->__upcast()->__value_, __k))
                             goto __done;
@@ -2038,7 +4567,8 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__emplace_unique_key_args(_Key const&
                     rehash(_VSTD::max<size_type>(2 * __bc + !__is_hash_power2(__bc),
                                                  size_type(ceil(float(size() + 1) / max_load_factor()))));
                     __bc = bucket_count();
-                    __chash = __constrain_hash(__hash, __bc);
+                    __chash = __bucket_index(__hash, __bc);
+                    __len = size_type(-1);
                 }
                 // insert_after __bucket_list_[__chash], or __first_node if bucket is null
                 __next_pointer __pn = __bucket_list_[__chash];
@@ -2050,7 +4580,7 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__emplace_unique_key_args(_Key const&
                     // fix up __bucket_list_
                     __bucket_list_[__chash] = __pn;
                     if (__h->__next_ != nullptr)
-                        __bucket_list_[__constrain_hash(__h->__next_->__hash(), __bc)]
+                        __bucket_list_[__bucket_index(__node_hash(__h->__next_), __bc)]
                                 = __h.get()->__ptr();
                 }
                 else
@@ -2061,6 +4591,12 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__emplace_unique_key_args(_Key const&
                 __nd = static_cast<__next_pointer>(__h.release());
                 // increment size
                 ++size();
+                if (__len != size_type(-1))
+                    __note_bucket_size(__len + 1, nullptr, __chash, __bc);
+                else
+                    __note_bucket_size(0, __nd, __chash, __bc);
+                __fingerprint_add(__chash, __hash);
+                this->__note_change();
                 __inserted = true;
             }
             __done:
@@ -2073,10 +4609,10 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__emplace_unique_key_args(_Key const&
 
 #ifndef _LIBCPP_CXX03_LANG
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         template <class... _Args>
-        pair<typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::iterator, bool>
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__emplace_unique_impl(_Args&&... __args)
+        pair<typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::iterator, bool>
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__emplace_unique_impl(_Args&&... __args)
         {
             __node_holder __h = __construct_node(_VSTD::forward<_Args>(__args)...);
             pair<iterator, bool> __r = __node_insert_unique(__h.get());
@@ -2085,10 +4621,10 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__emplace_unique_key_args(_Key const&
             return __r;
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         template <class... _Args>
-        typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::iterator
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__emplace_multi(_Args&&... __args)
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::iterator
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__emplace_multi(_Args&&... __args)
         {
             __node_holder __h = __construct_node(_VSTD::forward<_Args>(__args)...);
             iterator __r = __node_insert_multi(__h.get());
@@ -2096,10 +4632,10 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__emplace_unique_key_args(_Key const&
             return __r;
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         template <class... _Args>
-        typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::iterator
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__emplace_hint_multi(
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::iterator
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__emplace_hint_multi(
                 const_iterator __p, _Args&&... __args)
         {
 #if _LIBCPP_DEBUG_LEVEL >= 2
@@ -2115,9 +4651,9 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__emplace_unique_key_args(_Key const&
 
 #else // _LIBCPP_CXX03_LANG
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
-typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::iterator
-__hash_table<_Tp, _Hash, _Equal, _Alloc>::__insert_multi(const __container_value_type& __x)
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::iterator
+__hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__insert_multi(const __container_value_type& __x)
 {
     __node_holder __h = __construct_node(__x);
     iterator __r = __node_insert_multi(__h.get());
@@ -2125,9 +4661,9 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__insert_multi(const __container_value
     return __r;
 }
 
-template <class _Tp, class _Hash, class _Equal, class _Alloc>
-typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::iterator
-__hash_table<_Tp, _Hash, _Equal, _Alloc>::__insert_multi(const_iterator __p,
+template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::iterator
+__hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__insert_multi(const_iterator __p,
                                                          const __container_value_type& __x)
 {
 #if _LIBCPP_DEBUG_LEVEL >= 2
@@ -2143,14 +4679,14 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__insert_multi(const_iterator __p,
 
 #endif  // _LIBCPP_CXX03_LANG
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         void
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::rehash(size_type __n)
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::rehash(size_type __n)
         {
             if (__n == 1)
                 __n = 2;
             else if (__n & (__n - 1))
-                __n = __next_prime(__n);
+                __n = this->__pow2_mixing() ? __next_hash_pow2(__n) : __hash_next_prime(__n);
             size_type __bc = bucket_count();
             if (__n > __bc)
                 __rehash(__n);
@@ -2159,25 +4695,77 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__insert_multi(const_iterator __p,
                 __n = _VSTD::max<size_type>
                         (
                                 __n,
-                                __is_hash_power2(__bc) ? __next_hash_pow2(size_t(ceil(float(size()) / max_load_factor()))) :
-                                __next_prime(size_t(ceil(float(size()) / max_load_factor())))
+                                this->__pow2_mixing() || __is_hash_power2(__bc) ? __next_hash_pow2(size_t(ceil(float(size()) / max_load_factor()))) :
+                                __hash_next_prime(size_t(ceil(float(size()) / max_load_factor())))
                         );
                 if (__n < __bc)
                     __rehash(__n);
             }
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        void
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::bucket_huge_pages(size_type __min_bytes)
+        {
+            static_assert(__features::huge_pages::value,
+                          "bucket_huge_pages() needs hash_bucket_features<Key, Hash>::huge_pages");
+            this->__set_huge_page_threshold(__min_bytes);
+            size_type __bc = bucket_count();
+            const __bucket_list_deleter& __d = __bucket_list_.get_deleter();
+            if (__bc != 0 && __wants_huge_pages(__bucket_list_deleter::__words(__bc, __d.__tagged())) !=
+                             __d.__mapped())
+                __rehash(__bc);
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        void
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::bucket_pow2_mixing(bool __on)
+        {
+            static_assert(__features::pow2_mixing::value,
+                          "bucket_pow2_mixing() needs hash_bucket_features<Key, Hash>::pow2_mixing");
+            if (this->__pow2_mixing() == __on)
+                return;
+            this->__set_pow2_mixing(__on);
+            size_type __bc = bucket_count();
+            if (__bc != 0)
+                __rehash(__on ? __next_hash_pow2(__bc) : __bc);
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__node_pointer_pointer
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__allocate_buckets(
+                size_type __words, bool& __mapped, true_type)
+        {
+            if (__wants_huge_pages(__words) &&
+                __words <= __pointer_alloc_traits::max_size(__bucket_list_.get_deleter().__alloc()))
+            {
+                void* __p = __hash_huge_page_allocate(__words * sizeof(__next_pointer));
+                if (__p != nullptr)
+                {
+                    __mapped = true;
+                    return static_cast<__node_pointer_pointer>(__p);
+                }
+            }
+            __mapped = false;
+            return __pointer_alloc_traits::allocate(__bucket_list_.get_deleter().__alloc(), __words);
+        }
+
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         void
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__rehash(size_type __nbc)
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__rehash(size_type __nbc)
         {
 #if _LIBCPP_DEBUG_LEVEL >= 2
             __get_db()->__invalidate_all(this);
 #endif  // _LIBCPP_DEBUG_LEVEL >= 2
-            __pointer_allocator& __npa = __bucket_list_.get_deleter().__alloc();
+            this->__note_change();
+            bool __mapped = false;
+            bool __tagged = this->__fingerprinted() && __nbc > 0;
             __bucket_list_.reset(__nbc > 0 ?
-                                 __pointer_alloc_traits::allocate(__npa, __nbc) : nullptr);
+                __allocate_buckets(__bucket_list_deleter::__words(__nbc, __tagged), __mapped) : nullptr);
             __bucket_list_.get_deleter().size() = __nbc;
+            __bucket_list_.get_deleter().__reciprocal() = __reciprocal_type(__nbc, this->__pow2_mixing());
+            __bucket_list_.get_deleter().__set_mapped(__mapped);
+            __bucket_list_.get_deleter().__set_tagged(__tagged);
             if (__nbc > 0)
             {
                 for (size_type __i = 0; __i < __nbc; ++__i)
@@ -2186,13 +4774,13 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__insert_multi(const_iterator __p,
                 __next_pointer __cp = __pp->__next_;
                 if (__cp != nullptr)
                 {
-                    size_type __chash = __constrain_hash(__cp->__hash(), __nbc);
+                    size_type __chash = __bucket_index(__node_hash(__cp), __nbc);
                     __bucket_list_[__chash] = __pp;
                     size_type __phash = __chash;
                     for (__pp = __cp, __cp = __cp->__next_; __cp != nullptr;
                          __cp = __pp->__next_)
                     {
-                        __chash = __constrain_hash(__cp->__hash(), __nbc);
+                        __chash = __bucket_index(__node_hash(__cp), __nbc);
                         if (__chash == __phash)
                             __pp = __cp;
                         else
@@ -2220,64 +4808,77 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__insert_multi(const_iterator __p,
                     }
                 }
             }
+            __recount_bucket_size_bound();
+            __forget_bucket_size_bound();
+            __fill_fingerprints();
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         template <class _Key>
-        typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::iterator
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::find(const _Key& __k)
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::iterator
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::find(const _Key& __k, size_t __hash)
         {
-            size_t __hash = hash_function()(__k);
             size_type __bc = bucket_count();
             if (__bc != 0)
             {
-                size_t __chash = __constrain_hash(__hash, __bc);
+                size_t __chash = __bucket_index(__hash, __bc);
+                // The tag byte is dense, so a rejected lookup reads one line
+                // of it and neither the bucket slot nor any node.
+                if (__fingerprint_rejects(__chash, __hash))
+                    return end();
                 __next_pointer __nd = __bucket_list_[__chash];
                 if (__nd != nullptr)
                 {
-                    for (__nd = __nd->__next_; __nd != nullptr &&
-                                               (__nd->__hash() == __hash
-                                                || __constrain_hash(__nd->__hash(), __bc) == __chash);
-                         __nd = __nd->__next_)
+                    for (__nd = __nd->__next_; __nd != nullptr; __nd = __nd->__next_)
                     {
-                        if ((__nd->__hash() == __hash)
-                            && key_eq()(__nd->__upcast()->__value_, __k))
+                        size_t __nh = __node_hash(__nd);
+                        if (__nh == __hash)
+                        {
+                            if (key_eq()(__nd->__upcast()->__value_, __k))
 #if _LIBCPP_DEBUG_LEVEL >= 2
-                            return iterator(__nd, this);
+                                return iterator(__nd, this);
 #else
-                            return iterator(__nd);
+                                return iterator(__nd);
 #endif
+                        }
+                        else if (__bucket_index(__nh, __bc) != __chash)
+                            break;
                     }
                 }
             }
             return end();
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         template <class _Key>
-        typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::const_iterator
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::find(const _Key& __k) const
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::const_iterator
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::find(const _Key& __k, size_t __hash) const
         {
-            size_t __hash = hash_function()(__k);
             size_type __bc = bucket_count();
             if (__bc != 0)
             {
-                size_t __chash = __constrain_hash(__hash, __bc);
+                size_t __chash = __bucket_index(__hash, __bc);
+                // The tag byte is dense, so a rejected lookup reads one line
+                // of it and neither the bucket slot nor any node.
+                if (__fingerprint_rejects(__chash, __hash))
+                    return end();
                 __next_pointer __nd = __bucket_list_[__chash];
                 if (__nd != nullptr)
                 {
-                    for (__nd = __nd->__next_; __nd != nullptr &&
-                                               (__hash == __nd->__hash()
-                                                || __constrain_hash(__nd->__hash(), __bc) == __chash);
-                         __nd = __nd->__next_)
+                    for (__nd = __nd->__next_; __nd != nullptr; __nd = __nd->__next_)
                     {
-                        if ((__nd->__hash() == __hash)
-                            && key_eq()(__nd->__upcast()->__value_, __k))
+                        size_t __nh = __node_hash(__nd);
+                        if (__nh == __hash)
+                        {
+                            if (key_eq()(__nd->__upcast()->__value_, __k))
 #if _LIBCPP_DEBUG_LEVEL >= 2
-                            return const_iterator(__nd, this);
+                                return const_iterator(__nd, this);
 #else
-                            return const_iterator(__nd);
+                                return const_iterator(__nd);
 #endif
+                        }
+                        else if (__bucket_index(__nh, __bc) != __chash)
+                            break;
                     }
                 }
 
@@ -2287,10 +4888,10 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__insert_multi(const_iterator __p,
 
 #ifndef _LIBCPP_CXX03_LANG
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         template <class ..._Args>
-        typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::__node_holder
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__construct_node(_Args&& ...__args)
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__node_holder
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__construct_node(_Args&& ...__args)
         {
             static_assert(!__is_hash_value_type<_Args...>::value,
                           "Construct cannot be called with a hash value type");
@@ -2298,15 +4899,15 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__insert_multi(const_iterator __p,
             __node_holder __h(__node_traits::allocate(__na, 1), _Dp(__na));
             __node_traits::construct(__na, _NodeTypes::__get_ptr(__h->__value_), _VSTD::forward<_Args>(__args)...);
             __h.get_deleter().__value_constructed = true;
-            __h->__hash_ = hash_function()(__h->__value_);
+            __cache_node_hash(__h.get(), __caches_hash());
             __h->__next_ = nullptr;
             return __h;
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         template <class _First, class ..._Rest>
-        typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::__node_holder
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__construct_node_hash(
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__node_holder
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__construct_node_hash(
                 size_t __hash, _First&& __f, _Rest&& ...__rest)
         {
             static_assert(!__is_hash_value_type<_First, _Rest...>::value,
@@ -2317,45 +4918,45 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__insert_multi(const_iterator __p,
                                      _VSTD::forward<_First>(__f),
                                      _VSTD::forward<_Rest>(__rest)...);
             __h.get_deleter().__value_constructed = true;
-            __h->__hash_ = __hash;
+            __set_node_hash(__h.get(), __hash);
             __h->__next_ = nullptr;
             return __h;
         }
 
 #else  // _LIBCPP_CXX03_LANG
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
-typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::__node_holder
-__hash_table<_Tp, _Hash, _Equal, _Alloc>::__construct_node(const __container_value_type& __v)
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__node_holder
+__hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__construct_node(const __container_value_type& __v)
 {
     __node_allocator& __na = __node_alloc();
     __node_holder __h(__node_traits::allocate(__na, 1), _Dp(__na));
     __node_traits::construct(__na, _NodeTypes::__get_ptr(__h->__value_), __v);
     __h.get_deleter().__value_constructed = true;
-    __h->__hash_ = hash_function()(__h->__value_);
+    __cache_node_hash(__h.get(), __caches_hash());
     __h->__next_ = nullptr;
     return _LIBCPP_EXPLICIT_MOVE(__h);  // explicitly moved for C++03
 }
 
-template <class _Tp, class _Hash, class _Equal, class _Alloc>
-typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::__node_holder
-__hash_table<_Tp, _Hash, _Equal, _Alloc>::__construct_node_hash(size_t __hash,
+template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__node_holder
+__hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__construct_node_hash(size_t __hash,
                                                                 const __container_value_type& __v)
 {
     __node_allocator& __na = __node_alloc();
     __node_holder __h(__node_traits::allocate(__na, 1), _Dp(__na));
     __node_traits::construct(__na, _NodeTypes::__get_ptr(__h->__value_), __v);
     __h.get_deleter().__value_constructed = true;
-    __h->__hash_ = __hash;
+    __set_node_hash(__h.get(), __hash);
     __h->__next_ = nullptr;
     return _LIBCPP_EXPLICIT_MOVE(__h);  // explicitly moved for C++03
 }
 
 #endif  // _LIBCPP_CXX03_LANG
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
-        typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::iterator
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::erase(const_iterator __p)
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::iterator
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::erase(const_iterator __p)
         {
             __next_pointer __np = __p.__node_;
 #if _LIBCPP_DEBUG_LEVEL >= 2
@@ -2373,9 +4974,9 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__construct_node_hash(size_t __hash,
             return __r;
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
-        typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::iterator
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::erase(const_iterator __first,
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::iterator
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::erase(const_iterator __first,
                                                         const_iterator __last)
         {
 #if _LIBCPP_DEBUG_LEVEL >= 2
@@ -2399,25 +5000,27 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__construct_node_hash(size_t __hash,
 #endif
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         template <class _Key>
-        typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::size_type
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__erase_unique(const _Key& __k)
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::size_type
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__erase_unique(const _Key& __k,
+                                                                         size_t __hash)
         {
-            iterator __i = find(__k);
+            iterator __i = find(__k, __hash);
             if (__i == end())
                 return 0;
             erase(__i);
             return 1;
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         template <class _Key>
-        typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::size_type
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__erase_multi(const _Key& __k)
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::size_type
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__erase_multi(const _Key& __k,
+                                                                        size_t __hash)
         {
             size_type __r = 0;
-            iterator __i = find(__k);
+            iterator __i = find(__k, __hash);
             if (__i != end())
             {
                 iterator __e = end();
@@ -2430,14 +5033,14 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__construct_node_hash(size_t __hash,
             return __r;
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
-        typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::__node_holder
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::remove(const_iterator __p) _NOEXCEPT
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__node_holder
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::remove(const_iterator __p) _NOEXCEPT
         {
             // current node
             __next_pointer __cn = __p.__node_;
             size_type __bc = bucket_count();
-            size_t __chash = __constrain_hash(__cn->__hash(), __bc);
+            size_t __chash = __bucket_index(__node_hash(__cn), __bc);
             // find previous node
             __next_pointer __pn = __bucket_list_[__chash];
             for (; __pn->__next_ != __cn; __pn = __pn->__next_)
@@ -2446,16 +5049,16 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__construct_node_hash(size_t __hash,
             // if __pn is not in same bucket (before begin is not in same bucket) &&
             //    if __cn->__next_ is not in same bucket (nullptr is not in same bucket)
             if (__pn == __p1_.first().__ptr()
-                || __constrain_hash(__pn->__hash(), __bc) != __chash)
+                || __bucket_index(__node_hash(__pn), __bc) != __chash)
             {
                 if (__cn->__next_ == nullptr
-                    || __constrain_hash(__cn->__next_->__hash(), __bc) != __chash)
+                    || __bucket_index(__node_hash(__cn->__next_), __bc) != __chash)
                     __bucket_list_[__chash] = nullptr;
             }
             // if __cn->__next_ is not in same bucket (nullptr is in same bucket)
             if (__cn->__next_ != nullptr)
             {
-                size_t __nhash = __constrain_hash(__cn->__next_->__hash(), __bc);
+                size_t __nhash = __bucket_index(__node_hash(__cn->__next_), __bc);
                 if (__nhash != __chash)
                     __bucket_list_[__nhash] = __pn;
             }
@@ -2463,6 +5066,10 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__construct_node_hash(size_t __hash,
             __pn->__next_ = __cn->__next_;
             __cn->__next_ = nullptr;
             --size();
+            if (this->__bucket_size_bound_stale(size()))
+                __recount_bucket_size_bound();
+            __refresh_fingerprint(__chash);
+            this->__note_change();
 #if _LIBCPP_DEBUG_LEVEL >= 2
             __c_node* __c = __get_db()->__find_c_and_lock(this);
     for (__i_node** __dp = __c->end_; __dp != __c->beg_; )
@@ -2481,19 +5088,19 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__construct_node_hash(size_t __hash,
             return __node_holder(__cn->__upcast(), _Dp(__node_alloc(), true));
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         template <class _Key>
         inline
-        typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::size_type
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__count_unique(const _Key& __k) const
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::size_type
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__count_unique(const _Key& __k) const
         {
             return static_cast<size_type>(find(__k) != end());
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         template <class _Key>
-        typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::size_type
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__count_multi(const _Key& __k) const
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::size_type
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__count_multi(const _Key& __k) const
         {
             size_type __r = 0;
             const_iterator __i = find(__k);
@@ -2509,11 +5116,11 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__construct_node_hash(size_t __hash,
             return __r;
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         template <class _Key>
-        pair<typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::iterator,
-                typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::iterator>
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__equal_range_unique(
+        pair<typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::iterator,
+                typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::iterator>
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__equal_range_unique(
                 const _Key& __k)
         {
             iterator __i = find(__k);
@@ -2523,11 +5130,11 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__construct_node_hash(size_t __hash,
             return pair<iterator, iterator>(__i, __j);
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         template <class _Key>
-        pair<typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::const_iterator,
-                typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::const_iterator>
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__equal_range_unique(
+        pair<typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::const_iterator,
+                typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::const_iterator>
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__equal_range_unique(
                 const _Key& __k) const
         {
             const_iterator __i = find(__k);
@@ -2537,11 +5144,11 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__construct_node_hash(size_t __hash,
             return pair<const_iterator, const_iterator>(__i, __j);
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         template <class _Key>
-        pair<typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::iterator,
-                typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::iterator>
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__equal_range_multi(
+        pair<typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::iterator,
+                typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::iterator>
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__equal_range_multi(
                 const _Key& __k)
         {
             iterator __i = find(__k);
@@ -2557,11 +5164,11 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__construct_node_hash(size_t __hash,
             return pair<iterator, iterator>(__i, __j);
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         template <class _Key>
-        pair<typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::const_iterator,
-                typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::const_iterator>
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::__equal_range_multi(
+        pair<typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::const_iterator,
+                typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::const_iterator>
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__equal_range_multi(
                 const _Key& __k) const
         {
             const_iterator __i = find(__k);
@@ -2577,9 +5184,9 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__construct_node_hash(size_t __hash,
             return pair<const_iterator, const_iterator>(__i, __j);
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         void
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::swap(__hash_table& __u)
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::swap(__hash_table& __u)
 #if _LIBCPP_STD_VER <= 11
         _NOEXCEPT_DEBUG_(
                 __is_nothrow_swappable<hasher>::value && __is_nothrow_swappable<key_equal>::value
@@ -2601,27 +5208,29 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__construct_node_hash(size_t __hash,
                 __bucket_list_.reset(__u.__bucket_list_.release());
                 __u.__bucket_list_.reset(__npp);
             }
-            _VSTD::swap(__bucket_list_.get_deleter().size(), __u.__bucket_list_.get_deleter().size());
+            __bucket_list_.get_deleter().__swap_array(__u.__bucket_list_.get_deleter());
             __swap_allocator(__bucket_list_.get_deleter().__alloc(),
                              __u.__bucket_list_.get_deleter().__alloc());
             __swap_allocator(__node_alloc(), __u.__node_alloc());
             _VSTD::swap(__p1_.first().__next_, __u.__p1_.first().__next_);
             __p2_.swap(__u.__p2_);
             __p3_.swap(__u.__p3_);
+            this->__swap_state(__u);
+            _VSTD::swap(static_cast<__bucket_options&>(*this), static_cast<__bucket_options&>(__u));
             if (size() > 0)
-                __bucket_list_[__constrain_hash(__p1_.first().__next_->__hash(), bucket_count())] =
+                __bucket_list_[__bucket_index(__node_hash(__p1_.first().__next_), bucket_count())] =
                         __p1_.first().__ptr();
             if (__u.size() > 0)
-                __u.__bucket_list_[__constrain_hash(__u.__p1_.first().__next_->__hash(), __u.bucket_count())] =
+                __u.__bucket_list_[__u.__bucket_index(__u.__node_hash(__u.__p1_.first().__next_), __u.bucket_count())] =
                         __u.__p1_.first().__ptr();
 #if _LIBCPP_DEBUG_LEVEL >= 2
             __get_db()->swap(this, &__u);
 #endif
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
-        typename __hash_table<_Tp, _Hash, _Equal, _Alloc>::size_type
-        __hash_table<_Tp, _Hash, _Equal, _Alloc>::bucket_size(size_type __n) const
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
+        typename __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::size_type
+        __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::bucket_size(size_type __n) const
         {
             _LIBCPP_ASSERT(__n < bucket_count(),
                            "unordered container::bucket_size(n) called with n >= bucket_count()");
@@ -2631,18 +5240,18 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__construct_node_hash(size_t __hash,
             if (__np != nullptr)
             {
                 for (__np = __np->__next_; __np != nullptr &&
-                                           __constrain_hash(__np->__hash(), __bc) == __n;
+                                           __bucket_index(__node_hash(__np), __bc) == __n;
                      __np = __np->__next_, ++__r)
                     ;
             }
             return __r;
         }
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
         inline _LIBCPP_INLINE_VISIBILITY
         void
-        swap(__hash_table<_Tp, _Hash, _Equal, _Alloc>& __x,
-             __hash_table<_Tp, _Hash, _Equal, _Alloc>& __y)
+        swap(__hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>& __x,
+             __hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>& __y)
         _NOEXCEPT_(_NOEXCEPT_(__x.swap(__y)))
         {
             __x.swap(__y);
@@ -2650,30 +5259,30 @@ __hash_table<_Tp, _Hash, _Equal, _Alloc>::__construct_node_hash(size_t __hash,
 
 #if _LIBCPP_DEBUG_LEVEL >= 2
 
-        template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
 bool
-__hash_table<_Tp, _Hash, _Equal, _Alloc>::__dereferenceable(const const_iterator* __i) const
+__hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__dereferenceable(const const_iterator* __i) const
 {
     return __i->__node_ != nullptr;
 }
 
-template <class _Tp, class _Hash, class _Equal, class _Alloc>
+template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
 bool
-__hash_table<_Tp, _Hash, _Equal, _Alloc>::__decrementable(const const_iterator*) const
+__hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__decrementable(const const_iterator*) const
 {
     return false;
 }
 
-template <class _Tp, class _Hash, class _Equal, class _Alloc>
+template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
 bool
-__hash_table<_Tp, _Hash, _Equal, _Alloc>::__addable(const const_iterator*, ptrdiff_t) const
+__hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__addable(const const_iterator*, ptrdiff_t) const
 {
     return false;
 }
 
-template <class _Tp, class _Hash, class _Equal, class _Alloc>
+template <class _Tp, class _Hash, class _Equal, class _Alloc, class _Order>
 bool
-__hash_table<_Tp, _Hash, _Equal, _Alloc>::__subscriptable(const const_iterator*, ptrdiff_t) const
+__hash_table<_Tp, _Hash, _Equal, _Alloc, _Order>::__subscriptable(const const_iterator*, ptrdiff_t) const
 {
     return false;
 }
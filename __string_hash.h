@@ -0,0 +1,204 @@
+// -*- C++ -*-
+//===----------------------------------------------------------------------===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is dual licensed under the MIT and the University of Illinois Open
+// Source Licenses. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _LIBCPP__STRING_HASH
+#define _LIBCPP__STRING_HASH
+
+#include <__config>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#if _LIBCPP_STD_VER > 14
+#include <string_view>
+#endif
+
+#include <__undef_min_max>
+
+#if !defined(_LIBCPP_HAS_NO_PRAGMA_SYSTEM_HEADER)
+#pragma GCC system_header
+#endif
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+
+        // START ADDED CODE
+        // A wyhash-style byte hash. Everything reduces to 64x64->128 bit
+        // multiplies whose halves are folded with xor; keys of up to 16 bytes
+        // are read in at most four overlapping loads without a loop, longer
+        // ones 48 bytes per iteration on three independent lanes. Loads are
+        // native-endian, so hash values differ between byte orders, which
+        // unordered containers do not care about.
+        struct __wy_hash
+        {
+            static const uint64_t __s0 = 0x2d358dccaa6c78a5ULL;
+            static const uint64_t __s1 = 0x8bb84b93962eacc9ULL;
+            static const uint64_t __s2 = 0x4b33a62ed433d4a3ULL;
+            static const uint64_t __s3 = 0x4d5a2da51de1aa47ULL;
+
+            _LIBCPP_INLINE_VISIBILITY
+            static void __mum(uint64_t& __a, uint64_t& __b) _NOEXCEPT
+            {
+#if defined(__SIZEOF_INT128__)
+                __uint128_t __r = static_cast<__uint128_t>(__a) * __b;
+                __a = static_cast<uint64_t>(__r);
+                __b = static_cast<uint64_t>(__r >> 64);
+#else
+                uint64_t __ha = __a >> 32, __hb = __b >> 32;
+                uint64_t __la = static_cast<uint32_t>(__a), __lb = static_cast<uint32_t>(__b);
+                uint64_t __hh = __ha * __hb, __hl = __ha * __lb, __lh = __la * __hb, __ll = __la * __lb;
+                uint64_t __t = __ll + (__hl << 32);
+                uint64_t __lo = __t + (__lh << 32);
+                uint64_t __c = (__t < __ll) + (__lo < __t);
+                __b = __hh + (__hl >> 32) + (__lh >> 32) + __c;
+                __a = __lo;
+#endif
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            static uint64_t __mix(uint64_t __a, uint64_t __b) _NOEXCEPT
+            {
+                __mum(__a, __b);
+                return __a ^ __b;
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            static uint64_t __r8(const unsigned char* __p) _NOEXCEPT
+            {
+                uint64_t __v;
+                _VSTD::memcpy(&__v, __p, 8);
+                return __v;
+            }
+
+            _LIBCPP_INLINE_VISIBILITY
+            static uint64_t __r4(const unsigned char* __p) _NOEXCEPT
+            {
+                uint32_t __v;
+                _VSTD::memcpy(&__v, __p, 4);
+                return __v;
+            }
+
+            // 1 to 3 bytes: the first, middle and last, which between them
+            // cover every byte.
+            _LIBCPP_INLINE_VISIBILITY
+            static uint64_t __r3(const unsigned char* __p, size_t __n) _NOEXCEPT
+            {
+                return (uint64_t(__p[0]) << 16) | (uint64_t(__p[__n >> 1]) << 8) | __p[__n - 1];
+            }
+
+            // Done once per hasher rather than once per key.
+            _LIBCPP_INLINE_VISIBILITY
+            static uint64_t __prepare_seed(uint64_t __seed) _NOEXCEPT
+            {
+                return __seed ^ __mix(__seed ^ __s0, __s1);
+            }
+
+            // __seed comes from __prepare_seed.
+            static uint64_t __hash(const void* __key, size_t __len, uint64_t __seed) _NOEXCEPT
+            {
+                const unsigned char* __p = static_cast<const unsigned char*>(__key);
+                uint64_t __a, __b;
+                if (__len <= 16)
+                {
+                    if (__len >= 4)
+                    {
+                        size_t __d = (__len >> 3) << 2;
+                        __a = (__r4(__p) << 32) | __r4(__p + __d);
+                        __b = (__r4(__p + __len - 4) << 32) | __r4(__p + __len - 4 - __d);
+                    }
+                    else if (__len > 0)
+                    {
+                        __a = __r3(__p, __len);
+                        __b = 0;
+                    }
+                    else
+                        __a = __b = 0;
+                }
+                else
+                {
+                    size_t __i = __len;
+                    if (__i > 48)
+                    {
+                        uint64_t __see1 = __seed, __see2 = __seed;
+                        do
+                        {
+                            __seed = __mix(__r8(__p) ^ __s1, __r8(__p + 8) ^ __seed);
+                            __see1 = __mix(__r8(__p + 16) ^ __s2, __r8(__p + 24) ^ __see1);
+                            __see2 = __mix(__r8(__p + 32) ^ __s3, __r8(__p + 40) ^ __see2);
+                            __p += 48;
+                            __i -= 48;
+                        } while (__i > 48);
+                        __seed ^= __see1 ^ __see2;
+                    }
+                    while (__i > 16)
+                    {
+                        __seed = __mix(__r8(__p) ^ __s1, __r8(__p + 8) ^ __seed);
+                        __p += 16;
+                        __i -= 16;
+                    }
+                    // The last 16 bytes, overlapping what the loops read.
+                    __a = __r8(__p + __i - 16);
+                    __b = __r8(__p + __i - 8);
+                }
+                __a ^= __s1;
+                __b ^= __seed;
+                __mum(__a, __b);
+                return __mix(__a ^ __s0 ^ __len, __b ^ __s1);
+            }
+        };
+
+        // Hasher for strings and string views, for the _Hash parameter of the
+        // unordered containers in place of hash<basic_string>. Hashes the
+        // characters' bytes with __wy_hash; a nonzero seed gives an unrelated
+        // hash function, e.g. to make collisions hard to precompute.
+        // On 32-bit targets the 64-bit result is folded in half. Strings,
+        // views and C strings with the same characters hash alike, so with a
+        // transparent equality such as equal_to<> the containers look up any
+        // of them without building a key.
+        class _LIBCPP_TEMPLATE_VIS fast_string_hash
+        {
+            uint64_t __seed_;
+
+            _LIBCPP_INLINE_VISIBILITY
+            size_t __hash(const void* __p, size_t __n) const _NOEXCEPT
+            {
+                uint64_t __h = __wy_hash::__hash(__p, __n, __seed_);
+                return sizeof(size_t) < sizeof(uint64_t) ? static_cast<size_t>(__h ^ (__h >> 32))
+                                                         : static_cast<size_t>(__h);
+            }
+
+        public:
+            typedef void is_transparent;
+
+            _LIBCPP_INLINE_VISIBILITY
+            explicit fast_string_hash(uint64_t __seed = 0) _NOEXCEPT
+                    : __seed_(__wy_hash::__prepare_seed(__seed)) {}
+
+            template <class _CharT, class _Traits, class _Allocator>
+            _LIBCPP_INLINE_VISIBILITY
+            size_t operator()(const basic_string<_CharT, _Traits, _Allocator>& __s) const _NOEXCEPT
+            {return __hash(__s.data(), __s.size() * sizeof(_CharT));}
+
+            template <class _CharT>
+            _LIBCPP_INLINE_VISIBILITY
+            size_t operator()(const _CharT* __s) const _NOEXCEPT
+            {return __hash(__s, char_traits<_CharT>::length(__s) * sizeof(_CharT));}
+
+#if _LIBCPP_STD_VER > 14
+            template <class _CharT, class _Traits>
+            _LIBCPP_INLINE_VISIBILITY
+            size_t operator()(basic_string_view<_CharT, _Traits> __s) const _NOEXCEPT
+            {return __hash(__s.data(), __s.size() * sizeof(_CharT));}
+#endif
+        };
+        // END CODE
+
+_LIBCPP_END_NAMESPACE_STD
+
+#endif  // _LIBCPP__STRING_HASH
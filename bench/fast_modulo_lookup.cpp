@@ -0,0 +1,105 @@
+// Prime bucket counts reduced by division and by the precomputed
+// reciprocal (hash_bucket_features<...>::fast_modulo): bucket(k), which is
+// the reduction alone, and find() on a set that fits in cache and on one
+// that does not, both as independent lookups (throughput) and chained so
+// that each waits for the last (latency). The keys are random 64-bit values, so every hash exceeds
+// the bucket count and really is reduced. Each row runs in its own child
+// process, so that no table is built from memory another one freed. POSIX
+// only.
+//
+//   clang++ -std=c++14 -O2 -stdlib=libc++ bench/fast_modulo_lookup.cpp -o fast_modulo_lookup
+//   ./fast_modulo_lookup
+
+#include "../unordered_set.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+struct division_hash : std::hash<uint64_t> {};
+struct reciprocal_hash : std::hash<uint64_t> {};
+
+namespace std {
+template <>
+struct hash_bucket_features<uint64_t, reciprocal_hash>
+{
+    typedef true_type  fast_modulo;
+    typedef false_type pow2_mixing;
+    typedef false_type fingerprints;
+    typedef false_type huge_pages;
+};
+}
+
+typedef std::chrono::steady_clock Clock;
+
+static double ns_per(Clock::time_point t0, size_t ops)
+{
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / ops;
+}
+
+static volatile size_t sink;
+
+template <class Hash>
+static void run(const char* name, size_t n)
+{
+    typedef std::unordered_set<uint64_t, Hash, std::equal_to<uint64_t>, std::allocator<uint64_t>,
+                               std::ordered_iteration> Set;
+    std::mt19937_64 g(1);
+    Set s;
+    while (s.size() < n)
+        s.insert(g());
+    std::vector<uint64_t> keys(s.begin(), s.end());
+    std::shuffle(keys.begin(), keys.end(), g);
+    const size_t ops = 8000000;
+
+    size_t sum = 0;
+    Clock::time_point t0 = Clock::now();
+    for (size_t i = 0; i < ops; ++i)
+        sum += s.bucket(keys[i % n] + i);
+    double bucket_ns = ns_per(t0, ops);
+    t0 = Clock::now();
+    for (size_t i = 0; i < ops; ++i)
+        sum += s.count(keys[i % n]);
+    double find_ns = ns_per(t0, ops);
+    // Each key depends on the last result, so lookups cannot overlap.
+    size_t j = 0;
+    t0 = Clock::now();
+    for (size_t i = 0; i < ops; ++i)
+        j = (j + s.count(keys[(i + j) % n]) * 7) % n;
+    double chained_ns = ns_per(t0, ops);
+    sink = sum + j;
+    std::printf("%-10s %9zu %12zu %11.2f %10.1f %12.1f\n", name, n, s.bucket_count(), bucket_ns,
+                find_ns, chained_ns);
+}
+
+template <class Hash>
+static void run_apart(const char* name, size_t n)
+{
+    std::fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        run<Hash>(name, n);
+        std::exit(0);
+    }
+    int status;
+    waitpid(pid, &status, 0);
+}
+
+int main()
+{
+    std::printf("%-10s %9s %12s %11s %10s %12s\n", "reduction", "elements", "buckets", "bucket() ns",
+                "find ns", "chained ns");
+    const size_t sizes[] = {10000, 4000000};
+    for (size_t i = 0; i < 2; ++i)
+    {
+        run_apart<division_hash>("division", sizes[i]);
+        run_apart<reciprocal_hash>("reciprocal", sizes[i]);
+    }
+    return 0;
+}
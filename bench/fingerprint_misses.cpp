@@ -0,0 +1,72 @@
+// find() on a 90% negative workload with bucket_fingerprints() off and on.
+// Fingerprints are compiled in for key_hash below through
+// hash_bucket_features, so both rows use the same table type and only the
+// runtime setting differs.
+//
+//   clang++ -std=c++14 -O2 -stdlib=libc++ bench/fingerprint_misses.cpp -o fingerprint_misses
+//   ./fingerprint_misses
+
+#include "../unordered_set.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+template <class Key>
+struct key_hash : std::hash<Key> {};
+
+namespace std {
+template <class Key>
+struct hash_bucket_features<Key, key_hash<Key> >
+{
+    typedef false_type fast_modulo;
+    typedef false_type pow2_mixing;
+    typedef true_type  fingerprints;
+    typedef false_type huge_pages;
+};
+}
+
+static unsigned long long make_key(unsigned long long x, unsigned long long*) {return x;}
+static std::string make_key(unsigned long long x, std::string*)
+{
+    return std::to_string(x) + "_key_padding";
+}
+
+template <class Key>
+static void run(const char* key, size_t n)
+{
+    typedef std::unordered_set<Key, key_hash<Key> > Set;
+    const size_t lookups = 4000000;
+    for (int on = 0; on < 2; ++on)
+    {
+        std::mt19937_64 g(1);
+        Set s;
+        s.bucket_fingerprints(on != 0);
+        std::vector<Key> present;
+        for (size_t i = 0; i < n; ++i)
+        {
+            present.push_back(make_key(g(), static_cast<Key*>(nullptr)));
+            s.insert(present.back());
+        }
+        std::vector<Key> q;
+        for (size_t i = 0; i < lookups; ++i)
+            q.push_back(i % 10 == 0 ? present[g() % n] : make_key(g(), static_cast<Key*>(nullptr)));
+        size_t found = 0;
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < lookups; ++i)
+            found += s.count(q[i]);
+        double ns = std::chrono::duration<double, std::nano>(
+                        std::chrono::steady_clock::now() - t0).count() / lookups;
+        std::printf("%-7s %9zu %13s %10.1f %8zu\n", key, n, on ? "on" : "off", ns, found);
+    }
+}
+
+int main()
+{
+    std::printf("%-7s %9s %13s %10s %8s\n", "key", "elements", "fingerprints", "ns/find", "found");
+    run<unsigned long long>("uint64", 100000);
+    run<unsigned long long>("uint64", 4000000);
+    run<std::string>("string", 1000000);
+    return 0;
+}
@@ -0,0 +1,77 @@
+// The node-based unordered_set and the open-addressing flat_unordered_set
+// side by side: insert into an empty set, find of present and of absent
+// keys, and erase of every key, in ns per operation, for 64-bit and
+// 24-byte string keys.
+//
+//   clang++ -std=c++14 -O2 -stdlib=libc++ bench/flat_vs_node.cpp -o flat_vs_node
+//   ./flat_vs_node [elements]
+
+#include "../unordered_set.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static double ns_per(Clock::time_point t0, size_t ops)
+{
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / ops;
+}
+
+static unsigned long long make_key(unsigned long long x, unsigned long long*) {return x;}
+static std::string make_key(unsigned long long x, std::string*)
+{
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "key-%020llu", x);
+    return buf;
+}
+
+template <class Engine, class Key>
+static void run(const char* engine, const char* key, size_t n)
+{
+    typedef std::engine_unordered_set<Engine, Key> Set;
+    std::mt19937_64 g(1);
+    std::vector<Key> hits, misses;
+    for (size_t i = 0; i < n; ++i)
+    {
+        hits.push_back(make_key(g() | 1, static_cast<Key*>(nullptr)));
+        misses.push_back(make_key(g() & ~1ULL, static_cast<Key*>(nullptr)));
+    }
+    size_t sink = 0;
+    Set s;
+    Clock::time_point t0 = Clock::now();
+    for (size_t i = 0; i < n; ++i)
+        s.insert(hits[i]);
+    double insert_ns = ns_per(t0, n);
+    std::shuffle(hits.begin(), hits.end(), g);
+    t0 = Clock::now();
+    for (size_t i = 0; i < n; ++i)
+        sink += s.find(hits[i]) != s.end();
+    double hit_ns = ns_per(t0, n);
+    t0 = Clock::now();
+    for (size_t i = 0; i < n; ++i)
+        sink += s.find(misses[i]) != s.end();
+    double miss_ns = ns_per(t0, n);
+    t0 = Clock::now();
+    for (size_t i = 0; i < n; ++i)
+        sink += s.erase(hits[i]);
+    double erase_ns = ns_per(t0, n);
+    std::printf("%-6s %-7s %9.1f %9.1f %9.1f %9.1f%s\n", engine, key, insert_ns, hit_ns, miss_ns,
+                erase_ns, sink == 2 * n ? "" : " (wrong count)");
+}
+
+int main(int argc, char** argv)
+{
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    std::printf("%zu elements, ns per operation\n", n);
+    std::printf("%-6s %-7s %9s %9s %9s %9s\n", "engine", "key", "insert", "find hit", "miss", "erase");
+    run<std::node_hash_engine, unsigned long long>("node", "uint64", n);
+    run<std::flat_hash_engine, unsigned long long>("flat", "uint64", n);
+    run<std::node_hash_engine, std::string>("node", "string", n);
+    run<std::flat_hash_engine, std::string>("flat", "string", n);
+    return 0;
+}
@@ -0,0 +1,72 @@
+// unordered_set<int64_t> with nodes that cache their hash and with nodes
+// that do not (the default for std::hash<int64_t>): bytes allocated per
+// element, and the time of a rehash that doubles or halves the buckets.
+//
+//   clang++ -std=c++14 -O2 -stdlib=libc++ bench/hash_cache_memory.cpp -o hash_cache_memory
+//   ./hash_cache_memory [elements]
+
+#include "../unordered_set.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+static size_t live_bytes = 0;
+
+// std::allocator that keeps count of the bytes it has handed out.
+template <class T>
+struct counting_allocator : std::allocator<T>
+{
+    template <class U> struct rebind {typedef counting_allocator<U> other;};
+    counting_allocator() {}
+    template <class U> counting_allocator(const counting_allocator<U>&) {}
+    T* allocate(size_t n)
+    {
+        live_bytes += n * sizeof(T);
+        return std::allocator<T>::allocate(n);
+    }
+    void deallocate(T* p, size_t n)
+    {
+        live_bytes -= n * sizeof(T);
+        std::allocator<T>::deallocate(p, n);
+    }
+};
+
+// Same hash as std::hash, but nodes keep it.
+struct cached_hash : std::hash<int64_t> {};
+
+namespace std {
+template <>
+struct cache_hash_code<int64_t, cached_hash> : true_type {};
+}
+
+template <class Hash>
+static void run(const char* name, size_t n)
+{
+    typedef std::unordered_set<int64_t, Hash, std::equal_to<int64_t>, counting_allocator<int64_t>,
+                               std::ordered_iteration> Set;
+    std::mt19937_64 g(1);
+    Set s;
+    while (s.size() < n)
+        s.insert(static_cast<int64_t>(g()));
+    double bytes = static_cast<double>(live_bytes) / n;
+
+    size_t bc = s.bucket_count();
+    const int rehashes = 6;
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rehashes; ++r)
+        s.rehash(r % 2 == 0 ? 2 * bc : bc);
+    double ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - t0).count() / rehashes;
+    std::printf("%-12s %14.1f %12.1f\n", name, bytes, ms);
+}
+
+int main(int argc, char** argv)
+{
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4000000;
+    std::printf("%zu elements\n%-12s %14s %12s\n", n, "node hash", "bytes/element", "rehash ms");
+    run<cached_hash>("cached", n);
+    run<std::hash<int64_t> >("recomputed", n);
+    return 0;
+}
@@ -0,0 +1,78 @@
+// One string key probed against 1 to 16 sets that share a hasher: find(k)
+// on each set, which hashes the key every time, against hashing it once
+// and calling find_hashed(k, h) on each. Half of the keys are in every set
+// and half in none. Build without debug mode, which rehashes the key to
+// check h.
+//
+//   clang++ -std=c++14 -O2 -stdlib=libc++ bench/hash_once.cpp -o hash_once
+//   ./hash_once [key bytes]
+
+#include "../unordered_set.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+typedef std::unordered_set<std::string> Set;
+
+static double ns_per(Clock::time_point t0, size_t ops)
+{
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / ops;
+}
+
+static volatile size_t sink;
+
+static void run(size_t sets, const std::vector<std::string>& keys,
+                const std::vector<std::string>& probes)
+{
+    std::vector<Set> s(sets);
+    for (size_t i = 0; i < sets; ++i)
+        for (size_t j = 0; j < keys.size(); j += 2)
+            s[i].insert(keys[j]);
+
+    const size_t rounds = 4000000 / sets;
+    size_t found = 0;
+    Clock::time_point t0 = Clock::now();
+    for (size_t r = 0; r < rounds; ++r)
+    {
+        const std::string& k = probes[r % probes.size()];
+        for (size_t i = 0; i < sets; ++i)
+            found += s[i].find(k) != s[i].end();
+    }
+    double find_ns = ns_per(t0, rounds);
+
+    t0 = Clock::now();
+    for (size_t r = 0; r < rounds; ++r)
+    {
+        const std::string& k = probes[r % probes.size()];
+        size_t h = s[0].hash_function()(k);
+        for (size_t i = 0; i < sets; ++i)
+            found += s[i].find_hashed(k, h) != s[i].end();
+    }
+    double hashed_ns = ns_per(t0, rounds);
+    sink = found;
+    std::printf("%4zu %12.1f %16.1f %8.2f\n", sets, find_ns, hashed_ns, find_ns / hashed_ns);
+}
+
+int main(int argc, char** argv)
+{
+    size_t length = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 40;
+    std::mt19937_64 g(1);
+    std::vector<std::string> keys(1024, std::string(length, ' '));
+    for (size_t i = 0; i < keys.size(); ++i)
+        for (size_t j = 0; j < length; ++j)
+            keys[i][j] = static_cast<char>('a' + g() % 26);
+    std::vector<std::string> probes(keys);
+    std::shuffle(probes.begin(), probes.end(), g);
+
+    std::printf("%zu-byte keys, ns per key over all sets\n%4s %12s %16s %8s\n", length, "sets",
+                "find", "hash+find_hashed", "speedup");
+    const size_t counts[] = {1, 2, 4, 8, 16};
+    for (size_t i = 0; i < 5; ++i)
+        run(counts[i], keys, probes);
+    return 0;
+}
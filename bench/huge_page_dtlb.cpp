@@ -0,0 +1,106 @@
+// dTLB load misses and find() latency on a large set with its bucket array
+// on ordinary pages and with bucket_huge_pages() asking for 2 MiB ones.
+// The misses come from perf_event_open, which needs perf_event_paranoid
+// low enough or CAP_PERFMON; without it that column reads n/a. Whether
+// the array really got huge pages is up to the kernel's THP settings.
+// Linux only.
+//
+//   clang++ -std=c++14 -O2 -stdlib=libc++ bench/huge_page_dtlb.cpp -o huge_page_dtlb
+//   ./huge_page_dtlb [elements]
+
+#include "../unordered_set.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <random>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+struct key_hash : std::hash<uint64_t> {};
+
+namespace std {
+template <>
+struct hash_bucket_features<uint64_t, key_hash>
+{
+    typedef false_type fast_modulo;
+    typedef false_type pow2_mixing;
+    typedef false_type fingerprints;
+    typedef true_type  huge_pages;
+};
+}
+
+typedef std::unordered_set<uint64_t, key_hash, std::equal_to<uint64_t>, std::allocator<uint64_t>,
+                           std::ordered_iteration> Set;
+
+// A counter of dTLB read misses for this thread, or -1.
+static int open_dtlb_counter()
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+static void run(const char* name, size_t huge_page_bytes, size_t n)
+{
+    std::mt19937_64 g(1);
+    Set s;
+    s.bucket_huge_pages(huge_page_bytes);
+    std::vector<uint64_t> keys;
+    for (size_t i = 0; i < n; ++i)
+    {
+        keys.push_back(g());
+        s.insert(keys.back());
+    }
+    std::shuffle(keys.begin(), keys.end(), g);
+    // Half of the probes miss.
+    for (size_t i = 0; i < n; i += 2)
+        keys[i] = ~keys[i];
+
+    int fd = open_dtlb_counter();
+    if (fd >= 0)
+    {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+    size_t found = 0;
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i)
+        found += s.count(keys[i]);
+    double ns = std::chrono::duration<double, std::nano>(
+                    std::chrono::steady_clock::now() - t0).count() / n;
+    long long misses = -1;
+    if (fd >= 0)
+    {
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd, &misses, sizeof(misses)) != sizeof(misses))
+            misses = -1;
+        close(fd);
+    }
+    if (misses >= 0)
+        std::printf("%-14s %10.1f %16.3f %10zu\n", name, ns, static_cast<double>(misses) / n, found);
+    else
+        std::printf("%-14s %10.1f %16s %10zu\n", name, ns, "n/a", found);
+}
+
+int main(int argc, char** argv)
+{
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 16000000;
+    std::printf("%zu elements\n%-14s %10s %16s %10s\n", n, "bucket pages", "ns/find",
+                "dTLB misses/find", "found");
+    run("4 KiB", 0, n);
+    run("2 MiB", size_t(1) << 21, n);
+    return 0;
+}
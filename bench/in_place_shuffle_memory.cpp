@@ -0,0 +1,74 @@
+// Peak RSS and time of one begin_random(g) with the O(size()) node index
+// (the default) and with shuffle_in_place(true). Each mode runs in its own
+// child process; "extra peak" is VmHWM after the shuffle less VmRSS before
+// it, with VmHWM reset through /proc/self/clear_refs where the kernel
+// allows it. Linux only.
+//
+//   clang++ -std=c++14 -O2 -stdlib=libc++ bench/in_place_shuffle_memory.cpp -o in_place_shuffle_memory
+//   ./in_place_shuffle_memory [elements]
+
+#include "../unordered_set.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <sys/wait.h>
+#include <unistd.h>
+
+typedef std::unordered_set<long> Set;
+
+// A "Vm...:" line of /proc/self/status, in KiB.
+static long status_kib(const char* field)
+{
+    std::FILE* f = std::fopen("/proc/self/status", "r");
+    if (f == nullptr)
+        return -1;
+    char line[256];
+    long kib = -1;
+    size_t len = std::strlen(field);
+    while (std::fgets(line, sizeof(line), f) != nullptr)
+        if (std::strncmp(line, field, len) == 0)
+            kib = std::strtol(line + len + 1, nullptr, 10);
+    std::fclose(f);
+    return kib;
+}
+
+static void run(const char* name, bool in_place, size_t n)
+{
+    std::mt19937_64 g(1);
+    Set s;
+    s.reserve(n);
+    while (s.size() < n)
+        s.insert(static_cast<long>(g()));
+    s.shuffle_in_place(in_place);
+    if (std::FILE* f = std::fopen("/proc/self/clear_refs", "w"))
+    {
+        std::fputs("5", f);
+        std::fclose(f);
+    }
+    long before = status_kib("VmRSS:");
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    long sink = *s.begin_random(g);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    long peak = status_kib("VmHWM:");
+    std::printf("%-12s %10.1f %14ld %14ld\n", name, ms, before / 1024, (peak - before) / 1024);
+    std::exit(sink == 42);
+}
+
+int main(int argc, char** argv)
+{
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4000000;
+    std::printf("%zu elements\n%-12s %10s %14s %14s\n", n, "shuffle", "ms", "RSS MiB", "extra peak MiB");
+    std::fflush(stdout);
+    const bool modes[] = {false, true};
+    for (int m = 0; m < 2; ++m)
+    {
+        pid_t pid = fork();
+        if (pid == 0)
+            run(modes[m] ? "in place" : "node index", modes[m], n);
+        int status;
+        waitpid(pid, &status, 0);
+    }
+    return 0;
+}
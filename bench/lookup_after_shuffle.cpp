@@ -0,0 +1,62 @@
+// find() hit and miss latency on a set before any shuffle and after each
+// of several begin_random(g) calls. The shuffle rebuilds the bucket heads
+// as it relinks, so the rows should agree.
+//
+//   clang++ -std=c++14 -O2 -stdlib=libc++ bench/lookup_after_shuffle.cpp -o lookup_after_shuffle
+//   ./lookup_after_shuffle [elements]
+
+#include "../unordered_set.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+typedef std::unordered_set<long> Set;
+
+// Best of three passes, to keep other load on the machine out of the rows.
+static double ns_per_find(const Set& s, const std::vector<long>& keys, size_t& found)
+{
+    double best = 0;
+    for (int pass = 0; pass < 3; ++pass)
+    {
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < keys.size(); ++i)
+            found += s.find(keys[i]) != s.end();
+        double ns = std::chrono::duration<double, std::nano>(
+                        std::chrono::steady_clock::now() - t0).count() / keys.size();
+        if (pass == 0 || ns < best)
+            best = ns;
+    }
+    return best;
+}
+
+int main(int argc, char** argv)
+{
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    std::mt19937_64 g(1);
+    Set s;
+    std::vector<long> hits, misses;
+    while (s.size() < n)
+        s.insert(static_cast<long>(g() >> 1));
+    for (Set::const_iterator i = s.cbegin(); i != s.cend(); ++i)
+        hits.push_back(*i);
+    std::shuffle(hits.begin(), hits.end(), g);
+    for (size_t i = 0; i < n; ++i)
+        misses.push_back(-1 - static_cast<long>(g() >> 1));
+
+    size_t found = 0;
+    std::printf("%-16s %10s %10s\n", "state", "hit ns", "miss ns");
+    std::printf("%-16s %10.1f %10.1f\n", "never shuffled",
+                ns_per_find(s, hits, found), ns_per_find(s, misses, found));
+    for (int r = 1; r <= 3; ++r)
+    {
+        s.begin_random(g);
+        char label[32];
+        std::snprintf(label, sizeof(label), "after shuffle %d", r);
+        std::printf("%-16s %10.1f %10.1f\n", label,
+                    ns_per_find(s, hits, found), ns_per_find(s, misses, found));
+    }
+    return found != 12 * n;
+}
@@ -0,0 +1,72 @@
+// Shuffling a multiset with heavy duplication, and count() and
+// equal_range() before and after. Equal keys are shuffled as one unit and
+// stay adjacent, so the lookups should cost the same either side of the
+// shuffle; both walk the key's copies, so they grow with their number.
+//
+//   clang++ -std=c++14 -O2 -stdlib=libc++ bench/multiset_group_shuffle.cpp -o multiset_group_shuffle
+//   ./multiset_group_shuffle
+
+#include "../unordered_set.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iterator>
+#include <random>
+#include <vector>
+
+typedef std::unordered_multiset<long, std::hash<long>, std::equal_to<long>, std::allocator<long>,
+                                std::randomized_iteration> Multiset;
+typedef std::chrono::steady_clock Clock;
+
+static double ns_since(Clock::time_point t0)
+{
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+}
+
+// ns per count() and per equal_range() walked to its end, over all keys.
+static void lookups(const Multiset& s, const std::vector<long>& keys, double& count_ns,
+                    double& range_ns, size_t& sink)
+{
+    Clock::time_point t0 = Clock::now();
+    for (size_t i = 0; i < keys.size(); ++i)
+        sink += s.count(keys[i]);
+    count_ns = ns_since(t0) / keys.size();
+    t0 = Clock::now();
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        std::pair<Multiset::const_iterator, Multiset::const_iterator> r = s.equal_range(keys[i]);
+        sink += std::distance(r.first, r.second);
+    }
+    range_ns = ns_since(t0) / keys.size();
+}
+
+int main()
+{
+    const size_t elements = 1 << 21;
+    const size_t copies[] = {1, 16, 256};
+    std::mt19937_64 g(1);
+    size_t sink = 0;
+    std::printf("%7s %9s %11s %13s %13s %13s %13s\n", "copies", "keys", "shuffle ms",
+                "count ns", "after", "range ns", "after");
+    for (size_t c = 0; c < sizeof(copies) / sizeof(copies[0]); ++c)
+    {
+        size_t nkeys = elements / copies[c];
+        std::vector<long> keys;
+        for (size_t k = 0; k < nkeys; ++k)
+            keys.push_back(static_cast<long>(g()));
+        Multiset s;
+        for (size_t d = 0; d < copies[c]; ++d)
+            s.insert(keys.begin(), keys.end());
+        std::shuffle(keys.begin(), keys.end(), g);
+
+        double count_before, range_before, count_after, range_after;
+        lookups(s, keys, count_before, range_before, sink);
+        Clock::time_point t0 = Clock::now();
+        sink += *s.begin_random(g);
+        double shuffle_ms = ns_since(t0) / 1e6;
+        lookups(s, keys, count_after, range_after, sink);
+        std::printf("%7zu %9zu %11.1f %13.1f %13.1f %13.1f %13.1f\n", copies[c], nkeys, shuffle_ms,
+                    count_before, count_after, range_before, range_after);
+    }
+    return sink == 42;
+}
@@ -0,0 +1,58 @@
+// Speedup of begin_random(g) on 1, 2, 4, 8 and 16 threads over the serial
+// shuffle of the same set. One thread is the serial shuffle itself. Thread
+// counts above hardware_concurrency() still run, but cannot speed up.
+//
+//   clang++ -std=c++14 -O2 -stdlib=libc++ -pthread bench/parallel_shuffle.cpp -o parallel_shuffle
+//   ./parallel_shuffle [elements]
+
+#include "../unordered_set.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+
+typedef std::unordered_set<long> Set;
+
+// Best of three shuffles, in milliseconds.
+static double shuffle_ms(Set& s, std::mt19937_64& g, long& sink)
+{
+    double best = 0;
+    for (int r = 0; r < 3; ++r)
+    {
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        sink += *s.begin_random(g);
+        double ms = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - t0).count();
+        if (r == 0 || ms < best)
+            best = ms;
+    }
+    return best;
+}
+
+int main(int argc, char** argv)
+{
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 8000000;
+    std::mt19937_64 g(1);
+    Set s;
+    s.reserve(n);
+    while (s.size() < n)
+        s.insert(static_cast<long>(g()));
+    s.parallel_shuffle_threshold(0);
+
+    // A chain in allocation order walks faster than a shuffled one; start
+    // every row from a shuffled chain.
+    long sink = *s.begin_random(g);
+    s.shuffle_threads(1);
+    double serial = shuffle_ms(s, g, sink);
+    std::printf("%zu elements, %u hardware threads, serial shuffle %.1f ms\n",
+                n, std::thread::hardware_concurrency(), serial);
+    std::printf("%8s %10s %8s\n", "threads", "ms", "speedup");
+    for (unsigned t = 1; t <= 16; t *= 2)
+    {
+        s.shuffle_threads(t);
+        double ms = shuffle_ms(s, g, sink);
+        std::printf("%8u %10.1f %8.2f\n", t, ms, serial / ms);
+    }
+    return sink == 42;
+}
@@ -0,0 +1,87 @@
+// Strided integer keys under the identity std::hash, in a table with prime
+// bucket counts, with power-of-two counts and masking, and with
+// power-of-two counts and bucket_pow2_mixing(). For each it reports the
+// longest chain, the mean chain a successful lookup walks, and find() time.
+//
+//   clang++ -std=c++14 -O2 -stdlib=libc++ bench/pow2_mixing_strided.cpp -o pow2_mixing_strided
+//   ./pow2_mixing_strided [elements]
+
+#include "../unordered_set.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+struct key_hash : std::hash<uint64_t> {};
+
+namespace std {
+template <>
+struct hash_bucket_features<uint64_t, key_hash>
+{
+    typedef false_type fast_modulo;
+    typedef true_type  pow2_mixing;
+    typedef false_type fingerprints;
+    typedef false_type huge_pages;
+};
+}
+
+typedef std::unordered_set<uint64_t, key_hash, std::equal_to<uint64_t>, std::allocator<uint64_t>,
+                           std::ordered_iteration> Set;
+
+enum mode {prime, pow2_mask, pow2_mixed};
+
+static volatile size_t sink;
+
+static void run(mode m, uint64_t stride, size_t n)
+{
+    static const char* const names[] = {"prime", "pow2 mask", "pow2 mixed"};
+    Set s;
+    // A power-of-two bucket count above 2 makes growth keep to powers of two.
+    if (m == pow2_mask)
+        s.rehash(4);
+    else if (m == pow2_mixed)
+        s.bucket_pow2_mixing(true);
+    std::vector<uint64_t> keys;
+    for (size_t i = 0; i < n; ++i)
+    {
+        keys.push_back(i * stride);
+        s.insert(keys.back());
+    }
+
+    size_t longest = 0;
+    double walked = 0;
+    for (size_t b = 0; b < s.bucket_count(); ++b)
+    {
+        size_t len = s.bucket_size(b);
+        longest = std::max(longest, len);
+        walked += 0.5 * len * (len + 1);
+    }
+
+    std::mt19937_64 g(1);
+    std::shuffle(keys.begin(), keys.end(), g);
+    size_t lookups = std::min<size_t>(n, 200000);
+    size_t found = 0;
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < lookups; ++i)
+        found += s.count(keys[i]);
+    double ns = std::chrono::duration<double, std::nano>(
+                    std::chrono::steady_clock::now() - t0).count() / lookups;
+    sink = found;
+    std::printf("%8llu %-11s %10zu %9zu %11.2f %10.1f\n", static_cast<unsigned long long>(stride),
+                names[m], s.bucket_count(), longest, walked / n, ns);
+}
+
+int main(int argc, char** argv)
+{
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    std::printf("%zu keys 0, s, 2s, ...\n%8s %-11s %10s %9s %11s %10s\n", n, "stride", "table",
+                "buckets", "max chain", "mean walk", "ns/find");
+    const uint64_t strides[] = {1, 64, 4096};
+    for (size_t i = 0; i < 3; ++i)
+        for (int m = prime; m <= pow2_mixed; ++m)
+            run(static_cast<mode>(m), strides[i], n);
+    return 0;
+}
@@ -0,0 +1,66 @@
+// Latency distribution of random_element(g) at load factors from 0.25 up
+// to max_load_factor(). Each call is timed on its own, less the median cost
+// of reading the clock, so the percentiles are per call.
+//
+//   clang++ -std=c++14 -O2 -stdlib=libc++ bench/random_element_latency.cpp -o random_element_latency
+//   ./random_element_latency [elements]
+
+#include "../unordered_set.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+typedef std::unordered_set<long> Set;
+typedef std::chrono::steady_clock Clock;
+
+static double percentile(const std::vector<double>& sorted, double p)
+{
+    return sorted[static_cast<size_t>(p * (sorted.size() - 1))];
+}
+
+int main(int argc, char** argv)
+{
+    size_t n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    const size_t calls = 1000000;
+    std::mt19937_64 g(1);
+    std::vector<double> ns(calls);
+
+    for (size_t i = 0; i < calls; ++i)
+    {
+        Clock::time_point t0 = Clock::now();
+        ns[i] = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+    }
+    std::sort(ns.begin(), ns.end());
+    double clock_ns = percentile(ns, 0.5);
+
+    long sink = 0;
+    const double max_lf = Set().max_load_factor();
+    std::printf("clock overhead %.1f ns, subtracted\n", clock_ns);
+    std::printf("%11s %8s %8s %8s %8s %8s %8s\n",
+                "load factor", "mean", "p50", "p90", "p99", "p99.9", "max");
+    for (double lf = 0.25; lf <= max_lf + 1e-9; lf += 0.25)
+    {
+        Set s;
+        s.rehash(static_cast<size_t>(std::ceil(n / lf)));
+        while (s.size() < n)
+            s.insert(static_cast<long>(g()));
+        double total = 0;
+        for (size_t i = 0; i < calls; ++i)
+        {
+            Clock::time_point t0 = Clock::now();
+            sink += *s.random_element(g);
+            ns[i] = std::max(0.0, std::chrono::duration<double, std::nano>(Clock::now() - t0).count() -
+                                      clock_ns);
+            total += ns[i];
+        }
+        std::sort(ns.begin(), ns.end());
+        std::printf("%11.2f %8.1f %8.1f %8.1f %8.1f %8.1f %8.1f\n", s.load_factor(), total / calls,
+                    percentile(ns, 0.5), percentile(ns, 0.9), percentile(ns, 0.99),
+                    percentile(ns, 0.999), ns.back());
+    }
+    return sink == 42;
+}
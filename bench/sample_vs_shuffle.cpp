@@ -0,0 +1,60 @@
+// Drawing k random elements with sample(k, g, out) against shuffling the
+// whole set with begin_random(g) and taking its first k. sample() should
+// cost O(k) whatever the size; the shuffle costs O(size()) whatever k.
+//
+//   clang++ -std=c++14 -O2 -stdlib=libc++ bench/sample_vs_shuffle.cpp -o sample_vs_shuffle
+//   ./sample_vs_shuffle
+
+#include "../unordered_set.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+typedef std::unordered_set<long> Set;
+
+static double now_us()
+{
+    return std::chrono::duration<double, std::micro>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int main()
+{
+    const size_t sizes[] = {10000, 100000, 1000000};
+    const size_t ks[] = {1, 16, 256};
+    std::mt19937_64 g(1);
+    long sink = 0;
+    std::printf("%10s %6s %14s %14s\n", "elements", "k", "sample us", "shuffle us");
+    for (size_t si = 0; si < sizeof(sizes) / sizeof(sizes[0]); ++si)
+    {
+        Set s;
+        while (s.size() < sizes[si])
+            s.insert(static_cast<long>(g()));
+        for (size_t ki = 0; ki < sizeof(ks) / sizeof(ks[0]); ++ki)
+        {
+            size_t k = ks[ki];
+            std::vector<long> out(k);
+            const int reps = 200;
+            double t0 = now_us();
+            for (int r = 0; r < reps; ++r)
+            {
+                s.sample(k, g, out.begin());
+                sink += out[0];
+            }
+            double sample_us = (now_us() - t0) / reps;
+            const int shuffle_reps = 5;
+            t0 = now_us();
+            for (int r = 0; r < shuffle_reps; ++r)
+            {
+                Set::iterator it = s.begin_random(g);
+                for (size_t j = 0; j < k; ++j, ++it)
+                    out[j] = *it;
+                sink += out[0];
+            }
+            double shuffle_us = (now_us() - t0) / shuffle_reps;
+            std::printf("%10zu %6zu %14.2f %14.2f\n", sizes[si], k, sample_us, shuffle_us);
+        }
+    }
+    return sink == 42;
+}
@@ -0,0 +1,67 @@
+// Time per element of begin_random(g) as the set doubles in size, next to
+// the vector-and-erase shuffle begin_random() used to do. The linear
+// shuffle's ns/element rises only as the nodes fall out of cache; the old
+// one's doubles with n.
+//
+//   clang++ -std=c++14 -O2 -stdlib=libc++ bench/shuffle_scaling.cpp -o shuffle_scaling
+//   ./shuffle_scaling [max_elements]
+
+#include "../unordered_set.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+typedef std::unordered_set<long> Set;
+
+static double seconds_since(std::chrono::steady_clock::time_point t0)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// The former algorithm: gather iterators into a vector, then repeatedly
+// pick one at random and erase it from the vector.
+static long old_shuffle(const Set& s, std::mt19937_64& g)
+{
+    std::vector<Set::const_iterator> v;
+    for (Set::const_iterator i = s.begin(); i != s.end(); ++i)
+        v.push_back(i);
+    long sum = 0;
+    while (!v.empty())
+    {
+        size_t k = g() % v.size();
+        sum += *v[k];
+        v.erase(v.begin() + k);
+    }
+    return sum;
+}
+
+int main(int argc, char** argv)
+{
+    size_t max_n = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+    const size_t old_max_n = 256000;  // beyond this the old shuffle takes minutes
+    std::mt19937_64 g(1);
+    long sink = 0;
+    std::printf("%10s %18s %18s\n", "elements", "begin_random ns/el", "old shuffle ns/el");
+    for (size_t n = 1000; n <= max_n; n *= 2)
+    {
+        Set s;
+        for (size_t i = 0; i < n; ++i)
+            s.insert(static_cast<long>(g()));
+        int reps = n < 100000 ? 20 : 3;
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < reps; ++r)
+            sink += *s.begin_random(g);
+        double now_ns = seconds_since(t0) * 1e9 / reps / n;
+        if (n <= old_max_n)
+        {
+            t0 = std::chrono::steady_clock::now();
+            sink += old_shuffle(s, g);
+            std::printf("%10zu %18.1f %18.1f\n", n, now_ns, seconds_since(t0) * 1e9 / n);
+        }
+        else
+            std::printf("%10zu %18.1f %18s\n", n, now_ns, "-");
+    }
+    return sink == 42;
+}
@@ -0,0 +1,63 @@
+// Insert/erase churn on a set of steady size, and fill-then-clear cycles,
+// with std::allocator against hash_slab_allocator, in ns per operation.
+//
+//   clang++ -std=c++14 -O2 -stdlib=libc++ bench/slab_churn.cpp -o slab_churn
+//   ./slab_churn [live_elements]
+
+#include "../unordered_set.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static double ns_per(Clock::time_point t0, size_t ops)
+{
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / ops;
+}
+
+template <class Alloc>
+static void run(const char* name, size_t live)
+{
+    typedef std::unordered_set<long, std::hash<long>, std::equal_to<long>, Alloc> Set;
+    std::mt19937_64 g(1);
+    std::vector<long> keys(live);
+    Set s;
+    for (size_t i = 0; i < live; ++i)
+        s.insert(keys[i] = static_cast<long>(g()));
+
+    // Replace a random live key with a new one, over and over.
+    const size_t churn = 4000000;
+    Clock::time_point t0 = Clock::now();
+    for (size_t i = 0; i < churn; ++i)
+    {
+        size_t k = g() % live;
+        s.erase(keys[k]);
+        s.insert(keys[k] = static_cast<long>(g()));
+    }
+    double churn_ns = ns_per(t0, 2 * churn);
+
+    const int cycles = 20;
+    t0 = Clock::now();
+    for (int c = 0; c < cycles; ++c)
+    {
+        s.clear();
+        for (size_t i = 0; i < live; ++i)
+            s.insert(keys[i]);
+    }
+    double refill_ns = ns_per(t0, cycles * live);
+    std::printf("%-20s %12.1f %12.1f%s\n", name, churn_ns, refill_ns,
+                s.size() == live ? "" : " (wrong size)");
+}
+
+int main(int argc, char** argv)
+{
+    size_t live = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    std::printf("%zu live elements, ns per operation\n", live);
+    std::printf("%-20s %12s %12s\n", "allocator", "churn", "clear+fill");
+    run<std::allocator<long> >("std::allocator", live);
+    run<std::hash_slab_allocator<long> >("hash_slab_allocator", live);
+    return 0;
+}
@@ -0,0 +1,69 @@
+// std::hash<string> against fast_string_hash for keys of 8 to 4096 bytes:
+// hashing throughput on keys in cache, and end-to-end find() latency on a
+// set of such keys (every probe a hit, through a copy of the key so the
+// comparison reads both).
+//
+//   clang++ -std=c++14 -O2 -stdlib=libc++ bench/string_hash_lengths.cpp -o string_hash_lengths
+//   ./string_hash_lengths
+
+#include "../unordered_set.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static double ns_since(Clock::time_point t0)
+{
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+}
+
+static volatile size_t sink;
+
+template <class Hash>
+static void run(const char* name, const std::vector<std::string>& keys,
+                const std::vector<std::string>& probes, size_t length)
+{
+    // Throughput over a slice of the keys that stays in L1, so it measures
+    // the hash rather than the memory behind the keys.
+    Hash h;
+    size_t hot = std::max<size_t>(1, 32768 / length);
+    size_t sum = 0;
+    size_t bytes = 0;
+    Clock::time_point t0 = Clock::now();
+    while (bytes < (size_t(1) << 28))
+        for (size_t i = 0; i < hot; ++i, bytes += length)
+            sum += h(keys[i]);
+    double gbps = bytes / ns_since(t0);
+
+    std::unordered_set<std::string, Hash> s(keys.begin(), keys.end());
+    t0 = Clock::now();
+    for (size_t i = 0; i < probes.size(); ++i)
+        sum += s.count(probes[i]);
+    double find_ns = ns_since(t0) / probes.size();
+    sink = sum;
+    std::printf("%7zu %-16s %10.2f %10.1f\n", length, name, gbps, find_ns);
+}
+
+int main()
+{
+    std::mt19937_64 g(1);
+    std::printf("%7s %-16s %10s %10s\n", "bytes", "hash", "GB/s", "ns/find");
+    for (size_t length = 8; length <= 4096; length *= 2)
+    {
+        // Keep the key data near 64 MiB so long keys do not fill memory.
+        size_t n = std::min<size_t>(1000000, (size_t(64) << 20) / length);
+        std::vector<std::string> keys(n, std::string(length, ' '));
+        for (size_t i = 0; i < n; ++i)
+            for (size_t j = 0; j < length; ++j)
+                keys[i][j] = static_cast<char>('a' + g() % 26);
+        std::vector<std::string> probes(keys);
+        std::shuffle(probes.begin(), probes.end(), g);
+        run<std::hash<std::string> >("std::hash", keys, probes, length);
+        run<std::fast_string_hash>("fast_string_hash", keys, probes, length);
+    }
+    return 0;
+}
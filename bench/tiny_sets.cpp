@@ -0,0 +1,69 @@
+// Construction, lookup and destruction of many tiny string sets, like the
+// eight planets in main.cpp, as unordered_set and as small_unordered_set.
+// Times are ns per set for construction and destruction and ns per find
+// (half hits, half misses) for lookup.
+//
+//   clang++ -std=c++14 -O2 -stdlib=libc++ bench/tiny_sets.cpp -o tiny_sets
+//   ./tiny_sets
+
+#include "../unordered_set.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static double ns_per(Clock::time_point t0, size_t ops)
+{
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / ops;
+}
+
+static const char* const words[] = {
+    "Mercury", "Venus", "Earth", "Mars", "Jupiter", "Saturn", "Uranus", "Neptune",
+    "Ceres", "Pluto", "Haumea", "Makemake", "Eris", "Sedna", "Quaoar", "Orcus"};
+
+template <class Set>
+static void run(const char* name, size_t elements)
+{
+    const size_t sets = 100000;
+    std::vector<std::string> keys(words, words + elements);
+    std::vector<std::string> probes;
+    for (size_t i = 0; i < elements; ++i)
+    {
+        probes.push_back(words[i]);
+        probes.push_back(std::string(words[i]) + "!");
+    }
+    std::vector<Set> v;
+    v.reserve(sets);
+
+    Clock::time_point t0 = Clock::now();
+    for (size_t i = 0; i < sets; ++i)
+        v.emplace_back(keys.begin(), keys.end());
+    double construct_ns = ns_per(t0, sets);
+
+    size_t found = 0;
+    t0 = Clock::now();
+    for (size_t i = 0; i < sets; ++i)
+        for (size_t j = 0; j < probes.size(); ++j)
+            found += v[i].count(probes[j]);
+    double find_ns = ns_per(t0, sets * probes.size());
+
+    t0 = Clock::now();
+    v.clear();
+    double destroy_ns = ns_per(t0, sets);
+    std::printf("%-24s %8zu %10.1f %10.1f %10.1f%s\n", name, elements, construct_ns, find_ns,
+                destroy_ns, found == sets * elements ? "" : " (wrong count)");
+}
+
+int main()
+{
+    std::printf("%-24s %8s %10s %10s %10s\n", "set", "elements", "construct", "find", "destroy");
+    const size_t sizes[] = {4, 8, 16};
+    for (size_t i = 0; i < 3; ++i)
+    {
+        run<std::unordered_set<std::string> >("unordered_set", sizes[i]);
+        run<std::small_unordered_set<std::string, 16> >("small_unordered_set<16>", sizes[i]);
+    }
+    return 0;
+}
@@ -20,8 +20,15 @@
 namespace std
 {
 
+struct ordered_iteration;                       // hash order
+struct randomized_iteration;                    // reshuffled when modified
+template <unsigned long long Seed> struct seeded_iteration;
+
+template <class Key, class Hash> struct hash_bucket_features;  // all false_type; specialize to opt in
+                                                               // to bucket_pow2_mixing() etc.
+
 template <class Value, class Hash = hash<Value>, class Pred = equal_to<Value>,
-          class Alloc = allocator<Value>>
+          class Alloc = allocator<Value>, class Order = randomized_iteration>
 class unordered_set
 {
 public:
@@ -94,11 +101,11 @@ public:
     size_type size() const noexcept;
     size_type max_size() const noexcept;
 
-    iterator       begin() noexcept;
+    iterator       begin() noexcept;                  // reshuffles if modified since the last shuffle
     iterator       end() noexcept;
-    const_iterator begin()  const noexcept;
-    const_iterator end()    const noexcept;
-    const_iterator cbegin() const noexcept;
+    const_iterator begin()  const noexcept;           // never shuffles: the last shuffle's order, with
+    const_iterator end()    const noexcept;           // elements inserted since in their buckets' places
+    const_iterator cbegin() const noexcept;           // as begin() const
     const_iterator cend()   const noexcept;
 
     template <class... Args>
@@ -116,6 +123,8 @@ public:
     iterator erase(const_iterator position);
     iterator erase(iterator position);  // C++14
     size_type erase(const key_type& k);
+    template <class K>
+        size_type erase(const K& k);         // transparent Hash and Pred
     iterator erase(const_iterator first, const_iterator last);
     void clear() noexcept;
 
@@ -132,6 +141,22 @@ public:
     size_type count(const key_type& k) const;
     pair<iterator, iterator>             equal_range(const key_type& k);
     pair<const_iterator, const_iterator> equal_range(const key_type& k) const;
+    template <class K>                       // transparent Hash and Pred
+        iterator       find(const K& k);
+    template <class K>
+        const_iterator find(const K& k) const;
+    template <class K>
+        size_type count(const K& k) const;
+    template <class K>
+        pair<iterator, iterator>             equal_range(const K& k);
+    template <class K>
+        pair<const_iterator, const_iterator> equal_range(const K& k) const;
+
+    iterator       find_hashed(const key_type& k, size_t hash);     // hash == hash_function()(k)
+    const_iterator find_hashed(const key_type& k, size_t hash) const;
+    pair<iterator, bool> insert_hashed(const value_type& obj, size_t hash);
+    pair<iterator, bool> insert_hashed(value_type&& obj, size_t hash);
+    size_type erase_hashed(const key_type& k, size_t hash);
 
     size_type bucket_count() const noexcept;
     size_type max_bucket_count() const noexcept;
@@ -153,23 +178,23 @@ public:
     void reserve(size_type n);
 };
 
-template <class Value, class Hash, class Pred, class Alloc>
-    void swap(unordered_set<Value, Hash, Pred, Alloc>& x,
-              unordered_set<Value, Hash, Pred, Alloc>& y)
+template <class Value, class Hash, class Pred, class Alloc, class Order>
+    void swap(unordered_set<Value, Hash, Pred, Alloc, Order>& x,
+              unordered_set<Value, Hash, Pred, Alloc, Order>& y)
               noexcept(noexcept(x.swap(y)));
 
-template <class Value, class Hash, class Pred, class Alloc>
+template <class Value, class Hash, class Pred, class Alloc, class Order>
     bool
-    operator==(const unordered_set<Value, Hash, Pred, Alloc>& x,
-               const unordered_set<Value, Hash, Pred, Alloc>& y);
+    operator==(const unordered_set<Value, Hash, Pred, Alloc, Order>& x,
+               const unordered_set<Value, Hash, Pred, Alloc, Order>& y);
 
-template <class Value, class Hash, class Pred, class Alloc>
+template <class Value, class Hash, class Pred, class Alloc, class Order>
     bool
-    operator!=(const unordered_set<Value, Hash, Pred, Alloc>& x,
-               const unordered_set<Value, Hash, Pred, Alloc>& y);
+    operator!=(const unordered_set<Value, Hash, Pred, Alloc, Order>& x,
+               const unordered_set<Value, Hash, Pred, Alloc, Order>& y);
 
 template <class Value, class Hash = hash<Value>, class Pred = equal_to<Value>,
-          class Alloc = allocator<Value>>
+          class Alloc = allocator<Value>, class Order = ordered_iteration>
 class unordered_multiset
 {
 public:
@@ -242,11 +267,11 @@ public:
     size_type size() const noexcept;
     size_type max_size() const noexcept;
 
-    iterator       begin() noexcept;
+    iterator       begin() noexcept;                  // reshuffles if modified since the last shuffle
     iterator       end() noexcept;
-    const_iterator begin()  const noexcept;
-    const_iterator end()    const noexcept;
-    const_iterator cbegin() const noexcept;
+    const_iterator begin()  const noexcept;           // never shuffles: the last shuffle's order, with
+    const_iterator end()    const noexcept;           // elements inserted since in their buckets' places
+    const_iterator cbegin() const noexcept;           // as begin() const
     const_iterator cend()   const noexcept;
 
     template <class... Args>
@@ -264,6 +289,8 @@ public:
     iterator erase(const_iterator position);
     iterator erase(iterator position);  // C++14
     size_type erase(const key_type& k);
+    template <class K>
+        size_type erase(const K& k);         // transparent Hash and Pred
     iterator erase(const_iterator first, const_iterator last);
     void clear() noexcept;
 
@@ -280,6 +307,22 @@ public:
     size_type count(const key_type& k) const;
     pair<iterator, iterator>             equal_range(const key_type& k);
     pair<const_iterator, const_iterator> equal_range(const key_type& k) const;
+    template <class K>                       // transparent Hash and Pred
+        iterator       find(const K& k);
+    template <class K>
+        const_iterator find(const K& k) const;
+    template <class K>
+        size_type count(const K& k) const;
+    template <class K>
+        pair<iterator, iterator>             equal_range(const K& k);
+    template <class K>
+        pair<const_iterator, const_iterator> equal_range(const K& k) const;
+
+    iterator       find_hashed(const key_type& k, size_t hash);     // hash == hash_function()(k)
+    const_iterator find_hashed(const key_type& k, size_t hash) const;
+    iterator insert_hashed(const value_type& obj, size_t hash);
+    iterator insert_hashed(value_type&& obj, size_t hash);
+    size_type erase_hashed(const key_type& k, size_t hash);
 
     size_type bucket_count() const noexcept;
     size_type max_bucket_count() const noexcept;
@@ -301,20 +344,36 @@ public:
     void reserve(size_type n);
 };
 
-template <class Value, class Hash, class Pred, class Alloc>
-    void swap(unordered_multiset<Value, Hash, Pred, Alloc>& x,
-              unordered_multiset<Value, Hash, Pred, Alloc>& y)
+template <class Value, class Hash, class Pred, class Alloc, class Order>
+    void swap(unordered_multiset<Value, Hash, Pred, Alloc, Order>& x,
+              unordered_multiset<Value, Hash, Pred, Alloc, Order>& y)
               noexcept(noexcept(x.swap(y)));
 
-template <class Value, class Hash, class Pred, class Alloc>
+template <class Value, class Hash, class Pred, class Alloc, class Order>
     bool
-    operator==(const unordered_multiset<Value, Hash, Pred, Alloc>& x,
-               const unordered_multiset<Value, Hash, Pred, Alloc>& y);
+    operator==(const unordered_multiset<Value, Hash, Pred, Alloc, Order>& x,
+               const unordered_multiset<Value, Hash, Pred, Alloc, Order>& y);
 
-template <class Value, class Hash, class Pred, class Alloc>
+template <class Value, class Hash, class Pred, class Alloc, class Order>
     bool
-    operator!=(const unordered_multiset<Value, Hash, Pred, Alloc>& x,
-               const unordered_multiset<Value, Hash, Pred, Alloc>& y);
+    operator!=(const unordered_multiset<Value, Hash, Pred, Alloc, Order>& x,
+               const unordered_multiset<Value, Hash, Pred, Alloc, Order>& y);
+
+struct node_hash_engine;                        // unordered_set's node-based table
+struct flat_hash_engine;                        // open addressing
+struct dense_hash_engine;                       // one vector of elements, 32-bit links
+
+template <class Value, class Hash = hash<Value>, class Pred = equal_to<Value>,
+          class Alloc = allocator<Value>>
+    using flat_unordered_set = engine_unordered_set<flat_hash_engine, Value, Hash, Pred, Alloc>;
+template <class Value, class Hash = hash<Value>, class Pred = equal_to<Value>,
+          class Alloc = allocator<Value>>
+    using dense_unordered_set = engine_unordered_set<dense_hash_engine, Value, Hash, Pred, Alloc>;
+template <class Engine, class Value, class Hash = hash<Value>, class Pred = equal_to<Value>,
+          class Alloc = allocator<Value>>
+    using engine_unordered_set = unspecified;  // unordered_set<Value, Hash, Pred, Alloc> for
+                                               // node_hash_engine; otherwise unordered_set's
+                                               // interface less the extensions
 }  // std
 
 */
@@ -322,6 +381,9 @@ template <class Value, class Hash, class Pred, class Alloc>
 #include <__config>
 //#include <__hash_table>
 #include "__hash_table.h"
+#include "__flat_hash_table.h"
+#include "__dense_hash_table.h"
+#include "__string_hash.h"
 #include <functional>
 
 #include <__debug>
@@ -333,8 +395,20 @@ template <class Value, class Hash, class Pred, class Alloc>
 
 _LIBCPP_BEGIN_NAMESPACE_STD
 
+// START ADDED CODE
+#if _LIBCPP_STD_VER > 11
+// Lookups by a _K2 other than the key type go straight to the table, without
+// a key_type temporary, when both the hasher and the equality declare
+// is_transparent, e.g. fast_string_hash with equal_to<>.
+template <class _Hash, class _Pred, class _K2>
+struct __is_hash_transparent
+    : integral_constant<bool, __is_transparent<_Hash, _K2>::value &&
+                              __is_transparent<_Pred, _K2>::value> {};
+#endif
+// END CODE
+
 template <class _Value, class _Hash = hash<_Value>, class _Pred = equal_to<_Value>,
-          class _Alloc = allocator<_Value> >
+          class _Alloc = allocator<_Value>, class _Order = randomized_iteration>
 class _LIBCPP_TEMPLATE_VIS unordered_set {
 public:
     // types
@@ -349,7 +423,7 @@ public:
                   "Invalid allocator::value_type");
 
 private:
-    typedef __hash_table<value_type, hasher, key_equal, allocator_type> __table;
+    typedef __hash_table<value_type, hasher, key_equal, allocator_type, _Order> __table;
 
     __table __table_;
 
@@ -363,6 +437,7 @@ public:
     typedef typename __table::const_iterator const_iterator;
     typedef typename __table::const_local_iterator local_iterator;
     typedef typename __table::const_local_iterator const_local_iterator;
+    typedef typename __table::random_iterator random_iterator;
 
     _LIBCPP_INLINE_VISIBILITY
     unordered_set()
@@ -485,15 +560,83 @@ public:
 
 
     _LIBCPP_INLINE_VISIBILITY
-    iterator begin(){
+    iterator begin() _NOEXCEPT {
         // START ADDED CODE
-        return __table_.begin_random();
+        return __table_.__iteration_begin();
         // END CODE
 //        return __table.begin();
     }
+    // START ADDED CODE
+    // Under randomized_iteration (the default) and seeded_iteration, begin()
+    // keeps the order of the last shuffle until the set is modified;
+    // reshuffle() and begin_random(g) always draw a new one.
+    _LIBCPP_INLINE_VISIBILITY
+    iterator reshuffle() _NOEXCEPT {return __table_.reshuffle();}
+    // Reseeds the set's own generator, which reshuffle() draws from, and
+    // begin() too under a shuffling _Order; the current order is kept. Under
+    // seeded_iteration the generator starts from Seed, so the same calls give
+    // the same sequence of orders. Sets under ordered_iteration have no
+    // generator, so neither this nor reshuffle() compiles for them.
+    _LIBCPP_INLINE_VISIBILITY
+    void seed(unsigned long long __s) _NOEXCEPT {__table_.seed(__s);}
+    template <class _URBG>
+        _LIBCPP_INLINE_VISIBILITY
+        iterator begin_random(_URBG&& __g)
+            {return __table_.begin_random(_VSTD::forward<_URBG>(__g));}
+    template <class _URBG>
+        _LIBCPP_INLINE_VISIBILITY
+        random_iterator random_begin(_URBG&& __g) const
+            {return __table_.random_begin(_VSTD::forward<_URBG>(__g));}
+    _LIBCPP_INLINE_VISIBILITY
+    random_iterator random_end() const _NOEXCEPT {return __table_.random_end();}
+    // Writes __k independently and uniformly chosen elements to __out; an
+    // empty set writes nothing. Expected cost is O(__k). Under
+    // ordered_iteration the bound on the longest bucket is measured in
+    // O(size()) by the first sampling call after an insertion or rehash and
+    // cached with the buckets, so only that call pays for it.
+    template <class _URBG, class _OutputIterator>
+        _LIBCPP_INLINE_VISIBILITY
+        _OutputIterator sample(size_type __k, _URBG&& __g, _OutputIterator __out) const
+            {return __table_.__sample(__k, _VSTD::forward<_URBG>(__g), __out);}
+    // One uniformly chosen element, or end() if the set is empty. Expected
+    // O(1), plus the bound's measurement under ordered_iteration as for
+    // sample(); allocates
+    // nothing and leaves the node chain alone.
+    template <class _URBG>
+        _LIBCPP_INLINE_VISIBILITY
+        const_iterator random_element(_URBG&& __g) const
+            {return __table_.__random_element(_VSTD::forward<_URBG>(__g));}
+#ifndef _LIBCPP_CXX03_LANG
+    // Random order produced on demand, leaving the set's own order alone.
+    // Each element costs bucket_count() * B / size() random draws on average,
+    // B being the bound the set keeps on its longest bucket (measured as
+    // for sample() under ordered_iteration), and the iterator
+    // stores up to one entry per draw; so at a steady load factor, stopping
+    // after k elements costs O(k) time and space. Any number of these
+    // iterations may be live at once, but the set must not be modified while
+    // one is.
+    template <class _URBG>
+        using lazy_random_iterator = typename __table::template lazy_random_iterator<_URBG>;
+    template <class _URBG>
+        _LIBCPP_INLINE_VISIBILITY
+        lazy_random_iterator<_URBG> lazy_random_begin(_URBG& __g)
+            {return __table_.lazy_random_begin(__g);}
+    template <class _URBG>
+        _LIBCPP_INLINE_VISIBILITY
+        lazy_random_iterator<_URBG> lazy_random_end() _NOEXCEPT
+            {return __table_.template lazy_random_end<_URBG>();}
+#endif
+    // END CODE
 
     _LIBCPP_INLINE_VISIBILITY
     iterator       end() _NOEXCEPT          {return __table_.end();}
+    // START ADDED CODE
+    // A const begin() or cbegin() never shuffles, so concurrent readers are
+    // safe: it shows the order of the last shuffle, with any elements added
+    // since then in their buckets' places. Under seeded_iteration that is
+    // the seeded order only if nothing was inserted since a non-const
+    // begin(); call that first to iterate a modified set in seeded order.
+    // END CODE
     _LIBCPP_INLINE_VISIBILITY
     const_iterator begin()  const _NOEXCEPT {return __table_.begin();}
 
@@ -573,6 +716,15 @@ public:
     iterator erase(const_iterator __p) {return __table_.erase(__p);}
     _LIBCPP_INLINE_VISIBILITY
     size_type erase(const key_type& __k) {return __table_.__erase_unique(__k);}
+    // START ADDED CODE
+#if _LIBCPP_STD_VER > 11
+    template <class _K2>
+    _LIBCPP_INLINE_VISIBILITY
+    typename enable_if<__is_hash_transparent<hasher, key_equal, _K2>::value &&
+                       !is_convertible<const _K2&, const_iterator>::value, size_type>::type
+    erase(const _K2& __k) {return __table_.__erase_unique(__k);}
+#endif
+    // END CODE
     _LIBCPP_INLINE_VISIBILITY
     iterator erase(const_iterator __first, const_iterator __last)
         {return __table_.erase(__first, __last);}
@@ -602,6 +754,78 @@ public:
     pair<const_iterator, const_iterator> equal_range(const key_type& __k) const
         {return __table_.__equal_range_unique(__k);}
 
+    // START ADDED CODE
+#if _LIBCPP_STD_VER > 11
+    template <class _K2>
+    _LIBCPP_INLINE_VISIBILITY
+    typename enable_if<__is_hash_transparent<hasher, key_equal, _K2>::value, iterator>::type
+    find(const _K2& __k)       {return __table_.find(__k);}
+    template <class _K2>
+    _LIBCPP_INLINE_VISIBILITY
+    typename enable_if<__is_hash_transparent<hasher, key_equal, _K2>::value, const_iterator>::type
+    find(const _K2& __k) const {return __table_.find(__k);}
+    template <class _K2>
+    _LIBCPP_INLINE_VISIBILITY
+    typename enable_if<__is_hash_transparent<hasher, key_equal, _K2>::value, size_type>::type
+    count(const _K2& __k) const {return __table_.__count_unique(__k);}
+    template <class _K2>
+    _LIBCPP_INLINE_VISIBILITY
+    typename enable_if<__is_hash_transparent<hasher, key_equal, _K2>::value,
+                       pair<iterator, iterator> >::type
+    equal_range(const _K2& __k)
+        {return __table_.__equal_range_unique(__k);}
+    template <class _K2>
+    _LIBCPP_INLINE_VISIBILITY
+    typename enable_if<__is_hash_transparent<hasher, key_equal, _K2>::value,
+                       pair<const_iterator, const_iterator> >::type
+    equal_range(const _K2& __k) const
+        {return __table_.__equal_range_unique(__k);}
+#endif
+    // END CODE
+
+    // START ADDED CODE
+    // Lookups and updates by a hash the caller already has, which must be
+    // hash_function()(key), e.g. to probe several sets sharing a hasher
+    // while hashing the key once. Checked in debug mode.
+    _LIBCPP_INLINE_VISIBILITY
+    iterator       find_hashed(const key_type& __k, size_t __hash)
+    {
+        _LIBCPP_ASSERT(__hash == __table_.hash_function()(__k),
+                       "unordered_set::find_hashed(k, hash) called with hash != hash_function()(k)");
+        return __table_.find(__k, __hash);
+    }
+    _LIBCPP_INLINE_VISIBILITY
+    const_iterator find_hashed(const key_type& __k, size_t __hash) const
+    {
+        _LIBCPP_ASSERT(__hash == __table_.hash_function()(__k),
+                       "unordered_set::find_hashed(k, hash) called with hash != hash_function()(k)");
+        return __table_.find(__k, __hash);
+    }
+    _LIBCPP_INLINE_VISIBILITY
+    pair<iterator, bool> insert_hashed(const value_type& __x, size_t __hash)
+    {
+        _LIBCPP_ASSERT(__hash == __table_.hash_function()(__x),
+                       "unordered_set::insert_hashed(x, hash) called with hash != hash_function()(x)");
+        return __table_.__insert_unique_hashed(__hash, __x);
+    }
+#ifndef _LIBCPP_CXX03_LANG
+    _LIBCPP_INLINE_VISIBILITY
+    pair<iterator, bool> insert_hashed(value_type&& __x, size_t __hash)
+    {
+        _LIBCPP_ASSERT(__hash == __table_.hash_function()(__x),
+                       "unordered_set::insert_hashed(x, hash) called with hash != hash_function()(x)");
+        return __table_.__insert_unique_hashed(__hash, _VSTD::move(__x));
+    }
+#endif
+    _LIBCPP_INLINE_VISIBILITY
+    size_type erase_hashed(const key_type& __k, size_t __hash)
+    {
+        _LIBCPP_ASSERT(__hash == __table_.hash_function()(__k),
+                       "unordered_set::erase_hashed(k, hash) called with hash != hash_function()(k)");
+        return __table_.__erase_unique(__k, __hash);
+    }
+    // END CODE
+
     _LIBCPP_INLINE_VISIBILITY
     size_type bucket_count() const _NOEXCEPT {return __table_.bucket_count();}
     _LIBCPP_INLINE_VISIBILITY
@@ -636,6 +860,67 @@ public:
     _LIBCPP_INLINE_VISIBILITY
     void reserve(size_type __n) {__table_.reserve(__n);}
 
+    // START ADDED CODE
+    // Shuffles of sets with at least parallel_shuffle_threshold() elements
+    // run on shuffle_threads() threads; 0 threads means one per hardware thread.
+    // The default is one thread, so shuffles stay on the calling thread until
+    // shuffle_threads() is raised. Under ordered_iteration the set keeps none
+    // of these options: the getters report the defaults, which begin_random(g)
+    // uses, and the setters do not compile.
+    _LIBCPP_INLINE_VISIBILITY
+    size_type parallel_shuffle_threshold() const _NOEXCEPT
+        {return __table_.parallel_shuffle_threshold();}
+    _LIBCPP_INLINE_VISIBILITY
+    void parallel_shuffle_threshold(size_type __n) _NOEXCEPT
+        {__table_.parallel_shuffle_threshold() = __n;}
+    _LIBCPP_INLINE_VISIBILITY
+    unsigned shuffle_threads() const _NOEXCEPT {return __table_.shuffle_threads();}
+    _LIBCPP_INLINE_VISIBILITY
+    void shuffle_threads(unsigned __n) _NOEXCEPT {__table_.shuffle_threads() = __n;}
+    // A one-thread shuffle takes O(size()) time and an O(size()) index of the
+    // nodes. Without memory for the index, or with shuffle_in_place(true), it
+    // merge-shuffles the node chain instead: O(size() log size()) time, and
+    // nothing allocated.
+    _LIBCPP_INLINE_VISIBILITY
+    bool shuffle_in_place() const _NOEXCEPT {return __table_.shuffle_in_place();}
+    _LIBCPP_INLINE_VISIBILITY
+    void shuffle_in_place(bool __on) _NOEXCEPT {__table_.shuffle_in_place() = __on;}
+
+    // The bucket_* settings below exist only when hash_bucket_features<_Value,
+    // _Hash> turns them on, so that other sets pay nothing for them; without
+    // it the getter reports the setting off and the setter does not compile.
+    //
+    // With bucket fingerprints on, each bucket keeps a byte summarizing the
+    // hashes in it, and most lookups of absent keys finish without reading a
+    // node. The bytes share the bucket array's allocation, so changing the
+    // setting reallocates it like rehash(bucket_count()), in O(size()) and
+    // invalidating iterators.
+    _LIBCPP_INLINE_VISIBILITY
+    bool bucket_fingerprints() const _NOEXCEPT {return __table_.bucket_fingerprints();}
+    _LIBCPP_INLINE_VISIBILITY
+    void bucket_fingerprints(bool __on) {__table_.bucket_fingerprints(__on);}
+
+    // Bucket arrays of at least __min_bytes bytes are mapped on 2 MiB pages
+    // where the system allows it, cutting the TLB misses of lookups and
+    // rehashes in very large sets; 0, the default, turns this off. Moves the
+    // current bucket array, invalidating iterators, if that changes where it
+    // should live.
+    _LIBCPP_INLINE_VISIBILITY
+    size_type bucket_huge_pages() const _NOEXCEPT {return __table_.bucket_huge_pages();}
+    _LIBCPP_INLINE_VISIBILITY
+    void bucket_huge_pages(size_type __min_bytes) {__table_.bucket_huge_pages(__min_bytes);}
+
+    // With power-of-two mixing on, bucket counts are powers of two and a
+    // hash picks its bucket by a multiply and shift (Fibonacci hashing)
+    // rather than a remainder, which also keeps identity-like hashes of
+    // strided integers or aligned pointers from sharing a few buckets.
+    // Changing it rehashes, invalidating iterators.
+    _LIBCPP_INLINE_VISIBILITY
+    bool bucket_pow2_mixing() const _NOEXCEPT {return __table_.bucket_pow2_mixing();}
+    _LIBCPP_INLINE_VISIBILITY
+    void bucket_pow2_mixing(bool __on) {__table_.bucket_pow2_mixing(__on);}
+    // END CODE
+
 #if _LIBCPP_DEBUG_LEVEL >= 2
 
     bool __dereferenceable(const const_iterator* __i) const
@@ -651,8 +936,8 @@ public:
 
 };
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
-unordered_set<_Value, _Hash, _Pred, _Alloc>::unordered_set(size_type __n,
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
+unordered_set<_Value, _Hash, _Pred, _Alloc, _Order>::unordered_set(size_type __n,
         const hasher& __hf, const key_equal& __eql)
     : __table_(__hf, __eql)
 {
@@ -662,8 +947,8 @@ unordered_set<_Value, _Hash, _Pred, _Alloc>::unordered_set(size_type __n,
     __table_.rehash(__n);
 }
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
-unordered_set<_Value, _Hash, _Pred, _Alloc>::unordered_set(size_type __n,
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
+unordered_set<_Value, _Hash, _Pred, _Alloc, _Order>::unordered_set(size_type __n,
         const hasher& __hf, const key_equal& __eql, const allocator_type& __a)
     : __table_(__hf, __eql, __a)
 {
@@ -673,9 +958,9 @@ unordered_set<_Value, _Hash, _Pred, _Alloc>::unordered_set(size_type __n,
     __table_.rehash(__n);
 }
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
 template <class _InputIterator>
-unordered_set<_Value, _Hash, _Pred, _Alloc>::unordered_set(
+unordered_set<_Value, _Hash, _Pred, _Alloc, _Order>::unordered_set(
         _InputIterator __first, _InputIterator __last)
 {
 #if _LIBCPP_DEBUG_LEVEL >= 2
@@ -684,9 +969,9 @@ unordered_set<_Value, _Hash, _Pred, _Alloc>::unordered_set(
     insert(__first, __last);
 }
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
 template <class _InputIterator>
-unordered_set<_Value, _Hash, _Pred, _Alloc>::unordered_set(
+unordered_set<_Value, _Hash, _Pred, _Alloc, _Order>::unordered_set(
         _InputIterator __first, _InputIterator __last, size_type __n,
         const hasher& __hf, const key_equal& __eql)
     : __table_(__hf, __eql)
@@ -698,9 +983,9 @@ unordered_set<_Value, _Hash, _Pred, _Alloc>::unordered_set(
     insert(__first, __last);
 }
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
 template <class _InputIterator>
-unordered_set<_Value, _Hash, _Pred, _Alloc>::unordered_set(
+unordered_set<_Value, _Hash, _Pred, _Alloc, _Order>::unordered_set(
         _InputIterator __first, _InputIterator __last, size_type __n,
         const hasher& __hf, const key_equal& __eql, const allocator_type& __a)
     : __table_(__hf, __eql, __a)
@@ -712,9 +997,9 @@ unordered_set<_Value, _Hash, _Pred, _Alloc>::unordered_set(
     insert(__first, __last);
 }
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
 inline
-unordered_set<_Value, _Hash, _Pred, _Alloc>::unordered_set(
+unordered_set<_Value, _Hash, _Pred, _Alloc, _Order>::unordered_set(
         const allocator_type& __a)
     : __table_(__a)
 {
@@ -723,8 +1008,8 @@ unordered_set<_Value, _Hash, _Pred, _Alloc>::unordered_set(
 #endif
 }
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
-unordered_set<_Value, _Hash, _Pred, _Alloc>::unordered_set(
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
+unordered_set<_Value, _Hash, _Pred, _Alloc, _Order>::unordered_set(
         const unordered_set& __u)
     : __table_(__u.__table_)
 {
@@ -735,8 +1020,8 @@ unordered_set<_Value, _Hash, _Pred, _Alloc>::unordered_set(
     insert(__u.begin(), __u.end());
 }
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
-unordered_set<_Value, _Hash, _Pred, _Alloc>::unordered_set(
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
+unordered_set<_Value, _Hash, _Pred, _Alloc, _Order>::unordered_set(
         const unordered_set& __u, const allocator_type& __a)
     : __table_(__u.__table_, __a)
 {
@@ -749,9 +1034,9 @@ unordered_set<_Value, _Hash, _Pred, _Alloc>::unordered_set(
 
 #ifndef _LIBCPP_HAS_NO_RVALUE_REFERENCES
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
 inline
-unordered_set<_Value, _Hash, _Pred, _Alloc>::unordered_set(
+unordered_set<_Value, _Hash, _Pred, _Alloc, _Order>::unordered_set(
         unordered_set&& __u)
     _NOEXCEPT_(is_nothrow_move_constructible<__table>::value)
     : __table_(_VSTD::move(__u.__table_))
@@ -762,8 +1047,8 @@ unordered_set<_Value, _Hash, _Pred, _Alloc>::unordered_set(
 #endif
 }
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
-unordered_set<_Value, _Hash, _Pred, _Alloc>::unordered_set(
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
+unordered_set<_Value, _Hash, _Pred, _Alloc, _Order>::unordered_set(
         unordered_set&& __u, const allocator_type& __a)
     : __table_(_VSTD::move(__u.__table_), __a)
 {
@@ -786,8 +1071,8 @@ unordered_set<_Value, _Hash, _Pred, _Alloc>::unordered_set(
 
 #ifndef _LIBCPP_HAS_NO_GENERALIZED_INITIALIZERS
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
-unordered_set<_Value, _Hash, _Pred, _Alloc>::unordered_set(
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
+unordered_set<_Value, _Hash, _Pred, _Alloc, _Order>::unordered_set(
         initializer_list<value_type> __il)
 {
 #if _LIBCPP_DEBUG_LEVEL >= 2
@@ -796,8 +1081,8 @@ unordered_set<_Value, _Hash, _Pred, _Alloc>::unordered_set(
     insert(__il.begin(), __il.end());
 }
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
-unordered_set<_Value, _Hash, _Pred, _Alloc>::unordered_set(
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
+unordered_set<_Value, _Hash, _Pred, _Alloc, _Order>::unordered_set(
         initializer_list<value_type> __il, size_type __n, const hasher& __hf,
         const key_equal& __eql)
     : __table_(__hf, __eql)
@@ -809,8 +1094,8 @@ unordered_set<_Value, _Hash, _Pred, _Alloc>::unordered_set(
     insert(__il.begin(), __il.end());
 }
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
-unordered_set<_Value, _Hash, _Pred, _Alloc>::unordered_set(
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
+unordered_set<_Value, _Hash, _Pred, _Alloc, _Order>::unordered_set(
         initializer_list<value_type> __il, size_type __n, const hasher& __hf,
         const key_equal& __eql, const allocator_type& __a)
     : __table_(__hf, __eql, __a)
@@ -826,10 +1111,10 @@ unordered_set<_Value, _Hash, _Pred, _Alloc>::unordered_set(
 
 #ifndef _LIBCPP_HAS_NO_RVALUE_REFERENCES
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
 inline
-unordered_set<_Value, _Hash, _Pred, _Alloc>&
-unordered_set<_Value, _Hash, _Pred, _Alloc>::operator=(unordered_set&& __u)
+unordered_set<_Value, _Hash, _Pred, _Alloc, _Order>&
+unordered_set<_Value, _Hash, _Pred, _Alloc, _Order>::operator=(unordered_set&& __u)
     _NOEXCEPT_(is_nothrow_move_assignable<__table>::value)
 {
     __table_ = _VSTD::move(__u.__table_);
@@ -840,10 +1125,10 @@ unordered_set<_Value, _Hash, _Pred, _Alloc>::operator=(unordered_set&& __u)
 
 #ifndef _LIBCPP_HAS_NO_GENERALIZED_INITIALIZERS
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
 inline
-unordered_set<_Value, _Hash, _Pred, _Alloc>&
-unordered_set<_Value, _Hash, _Pred, _Alloc>::operator=(
+unordered_set<_Value, _Hash, _Pred, _Alloc, _Order>&
+unordered_set<_Value, _Hash, _Pred, _Alloc, _Order>::operator=(
         initializer_list<value_type> __il)
 {
     __table_.__assign_unique(__il.begin(), __il.end());
@@ -852,35 +1137,35 @@ unordered_set<_Value, _Hash, _Pred, _Alloc>::operator=(
 
 #endif  // _LIBCPP_HAS_NO_GENERALIZED_INITIALIZERS
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
 template <class _InputIterator>
 inline
 void
-unordered_set<_Value, _Hash, _Pred, _Alloc>::insert(_InputIterator __first,
+unordered_set<_Value, _Hash, _Pred, _Alloc, _Order>::insert(_InputIterator __first,
                                                     _InputIterator __last)
 {
     for (; __first != __last; ++__first)
         __table_.__insert_unique(*__first);
 }
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
 inline _LIBCPP_INLINE_VISIBILITY
 void
-swap(unordered_set<_Value, _Hash, _Pred, _Alloc>& __x,
-     unordered_set<_Value, _Hash, _Pred, _Alloc>& __y)
+swap(unordered_set<_Value, _Hash, _Pred, _Alloc, _Order>& __x,
+     unordered_set<_Value, _Hash, _Pred, _Alloc, _Order>& __y)
     _NOEXCEPT_(_NOEXCEPT_(__x.swap(__y)))
 {
     __x.swap(__y);
 }
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
 bool
-operator==(const unordered_set<_Value, _Hash, _Pred, _Alloc>& __x,
-           const unordered_set<_Value, _Hash, _Pred, _Alloc>& __y)
+operator==(const unordered_set<_Value, _Hash, _Pred, _Alloc, _Order>& __x,
+           const unordered_set<_Value, _Hash, _Pred, _Alloc, _Order>& __y)
 {
     if (__x.size() != __y.size())
         return false;
-    typedef typename unordered_set<_Value, _Hash, _Pred, _Alloc>::const_iterator
+    typedef typename unordered_set<_Value, _Hash, _Pred, _Alloc, _Order>::const_iterator
                                                                  const_iterator;
     for (const_iterator __i = __x.begin(), __ex = __x.end(), __ey = __y.end();
             __i != __ex; ++__i)
@@ -892,17 +1177,17 @@ operator==(const unordered_set<_Value, _Hash, _Pred, _Alloc>& __x,
     return true;
 }
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
 inline _LIBCPP_INLINE_VISIBILITY
 bool
-operator!=(const unordered_set<_Value, _Hash, _Pred, _Alloc>& __x,
-           const unordered_set<_Value, _Hash, _Pred, _Alloc>& __y)
+operator!=(const unordered_set<_Value, _Hash, _Pred, _Alloc, _Order>& __x,
+           const unordered_set<_Value, _Hash, _Pred, _Alloc, _Order>& __y)
 {
     return !(__x == __y);
 }
 
 template <class _Value, class _Hash = hash<_Value>, class _Pred = equal_to<_Value>,
-          class _Alloc = allocator<_Value> >
+          class _Alloc = allocator<_Value>, class _Order = ordered_iteration>
 class _LIBCPP_TEMPLATE_VIS unordered_multiset
 {
 public:
@@ -918,7 +1203,7 @@ public:
                   "Invalid allocator::value_type");
 
 private:
-    typedef __hash_table<value_type, hasher, key_equal, allocator_type> __table;
+    typedef __hash_table<value_type, hasher, key_equal, allocator_type, _Order> __table;
 
     __table __table_;
 
@@ -932,6 +1217,7 @@ public:
     typedef typename __table::const_iterator       const_iterator;
     typedef typename __table::const_local_iterator local_iterator;
     typedef typename __table::const_local_iterator const_local_iterator;
+    typedef typename __table::random_iterator random_iterator;
 
     _LIBCPP_INLINE_VISIBILITY
     unordered_multiset()
@@ -1030,9 +1316,41 @@ public:
     size_type max_size() const _NOEXCEPT {return __table_.max_size();}
 
     _LIBCPP_INLINE_VISIBILITY
-    iterator       begin() _NOEXCEPT        {return __table_.begin();}
+    iterator       begin() _NOEXCEPT        {return __table_.__iteration_begin();}
+    // START ADDED CODE
+    // With a shuffling _Order, equal elements are moved as one group and stay
+    // adjacent, so count() and equal_range() keep their per-bucket cost.
+    _LIBCPP_INLINE_VISIBILITY
+    iterator reshuffle() _NOEXCEPT {return __table_.reshuffle();}
+    // Reseeds the set's own generator, which reshuffle() draws from, and
+    // begin() too under a shuffling _Order; the current order is kept. Under
+    // seeded_iteration the generator starts from Seed, so the same calls give
+    // the same sequence of orders. Sets under ordered_iteration have no
+    // generator, so neither this nor reshuffle() compiles for them.
+    _LIBCPP_INLINE_VISIBILITY
+    void seed(unsigned long long __s) _NOEXCEPT {__table_.seed(__s);}
+    template <class _URBG>
+        _LIBCPP_INLINE_VISIBILITY
+        iterator begin_random(_URBG&& __g)
+            {return __table_.begin_random(_VSTD::forward<_URBG>(__g));}
+    // Random bucket order without relinking anything; equal elements come
+    // out together because they share a bucket run.
+    template <class _URBG>
+        _LIBCPP_INLINE_VISIBILITY
+        random_iterator random_begin(_URBG&& __g) const
+            {return __table_.random_begin(_VSTD::forward<_URBG>(__g));}
+    _LIBCPP_INLINE_VISIBILITY
+    random_iterator random_end() const _NOEXCEPT {return __table_.random_end();}
+    // END CODE
     _LIBCPP_INLINE_VISIBILITY
     iterator       end() _NOEXCEPT          {return __table_.end();}
+    // START ADDED CODE
+    // A const begin() or cbegin() never shuffles, so concurrent readers are
+    // safe: it shows the order of the last shuffle, with any elements added
+    // since then in their buckets' places. Under seeded_iteration that is
+    // the seeded order only if nothing was inserted since a non-const
+    // begin(); call that first to iterate a modified set in seeded order.
+    // END CODE
     _LIBCPP_INLINE_VISIBILITY
     const_iterator begin()  const _NOEXCEPT {return __table_.begin();}
     _LIBCPP_INLINE_VISIBILITY
@@ -1079,6 +1397,15 @@ public:
     iterator erase(const_iterator __p) {return __table_.erase(__p);}
     _LIBCPP_INLINE_VISIBILITY
     size_type erase(const key_type& __k) {return __table_.__erase_multi(__k);}
+    // START ADDED CODE
+#if _LIBCPP_STD_VER > 11
+    template <class _K2>
+    _LIBCPP_INLINE_VISIBILITY
+    typename enable_if<__is_hash_transparent<hasher, key_equal, _K2>::value &&
+                       !is_convertible<const _K2&, const_iterator>::value, size_type>::type
+    erase(const _K2& __k) {return __table_.__erase_multi(__k);}
+#endif
+    // END CODE
     _LIBCPP_INLINE_VISIBILITY
     iterator erase(const_iterator __first, const_iterator __last)
         {return __table_.erase(__first, __last);}
@@ -1108,6 +1435,78 @@ public:
     pair<const_iterator, const_iterator> equal_range(const key_type& __k) const
         {return __table_.__equal_range_multi(__k);}
 
+    // START ADDED CODE
+#if _LIBCPP_STD_VER > 11
+    template <class _K2>
+    _LIBCPP_INLINE_VISIBILITY
+    typename enable_if<__is_hash_transparent<hasher, key_equal, _K2>::value, iterator>::type
+    find(const _K2& __k)       {return __table_.find(__k);}
+    template <class _K2>
+    _LIBCPP_INLINE_VISIBILITY
+    typename enable_if<__is_hash_transparent<hasher, key_equal, _K2>::value, const_iterator>::type
+    find(const _K2& __k) const {return __table_.find(__k);}
+    template <class _K2>
+    _LIBCPP_INLINE_VISIBILITY
+    typename enable_if<__is_hash_transparent<hasher, key_equal, _K2>::value, size_type>::type
+    count(const _K2& __k) const {return __table_.__count_multi(__k);}
+    template <class _K2>
+    _LIBCPP_INLINE_VISIBILITY
+    typename enable_if<__is_hash_transparent<hasher, key_equal, _K2>::value,
+                       pair<iterator, iterator> >::type
+    equal_range(const _K2& __k)
+        {return __table_.__equal_range_multi(__k);}
+    template <class _K2>
+    _LIBCPP_INLINE_VISIBILITY
+    typename enable_if<__is_hash_transparent<hasher, key_equal, _K2>::value,
+                       pair<const_iterator, const_iterator> >::type
+    equal_range(const _K2& __k) const
+        {return __table_.__equal_range_multi(__k);}
+#endif
+    // END CODE
+
+    // START ADDED CODE
+    // Lookups and updates by a hash the caller already has, which must be
+    // hash_function()(key), e.g. to probe several sets sharing a hasher
+    // while hashing the key once. Checked in debug mode.
+    _LIBCPP_INLINE_VISIBILITY
+    iterator       find_hashed(const key_type& __k, size_t __hash)
+    {
+        _LIBCPP_ASSERT(__hash == __table_.hash_function()(__k),
+                       "unordered_multiset::find_hashed(k, hash) called with hash != hash_function()(k)");
+        return __table_.find(__k, __hash);
+    }
+    _LIBCPP_INLINE_VISIBILITY
+    const_iterator find_hashed(const key_type& __k, size_t __hash) const
+    {
+        _LIBCPP_ASSERT(__hash == __table_.hash_function()(__k),
+                       "unordered_multiset::find_hashed(k, hash) called with hash != hash_function()(k)");
+        return __table_.find(__k, __hash);
+    }
+    _LIBCPP_INLINE_VISIBILITY
+    iterator insert_hashed(const value_type& __x, size_t __hash)
+    {
+        _LIBCPP_ASSERT(__hash == __table_.hash_function()(__x),
+                       "unordered_multiset::insert_hashed(x, hash) called with hash != hash_function()(x)");
+        return __table_.__insert_multi_hashed(__hash, __x);
+    }
+#ifndef _LIBCPP_CXX03_LANG
+    _LIBCPP_INLINE_VISIBILITY
+    iterator insert_hashed(value_type&& __x, size_t __hash)
+    {
+        _LIBCPP_ASSERT(__hash == __table_.hash_function()(__x),
+                       "unordered_multiset::insert_hashed(x, hash) called with hash != hash_function()(x)");
+        return __table_.__insert_multi_hashed(__hash, _VSTD::move(__x));
+    }
+#endif
+    _LIBCPP_INLINE_VISIBILITY
+    size_type erase_hashed(const key_type& __k, size_t __hash)
+    {
+        _LIBCPP_ASSERT(__hash == __table_.hash_function()(__k),
+                       "unordered_multiset::erase_hashed(k, hash) called with hash != hash_function()(k)");
+        return __table_.__erase_multi(__k, __hash);
+    }
+    // END CODE
+
     _LIBCPP_INLINE_VISIBILITY
     size_type bucket_count() const _NOEXCEPT {return __table_.bucket_count();}
     _LIBCPP_INLINE_VISIBILITY
@@ -1142,6 +1541,67 @@ public:
     _LIBCPP_INLINE_VISIBILITY
     void reserve(size_type __n) {__table_.reserve(__n);}
 
+    // START ADDED CODE
+    // Shuffles of sets with at least parallel_shuffle_threshold() elements
+    // run on shuffle_threads() threads; 0 threads means one per hardware thread.
+    // The default is one thread, so shuffles stay on the calling thread until
+    // shuffle_threads() is raised. Under ordered_iteration the set keeps none
+    // of these options: the getters report the defaults, which begin_random(g)
+    // uses, and the setters do not compile.
+    _LIBCPP_INLINE_VISIBILITY
+    size_type parallel_shuffle_threshold() const _NOEXCEPT
+        {return __table_.parallel_shuffle_threshold();}
+    _LIBCPP_INLINE_VISIBILITY
+    void parallel_shuffle_threshold(size_type __n) _NOEXCEPT
+        {__table_.parallel_shuffle_threshold() = __n;}
+    _LIBCPP_INLINE_VISIBILITY
+    unsigned shuffle_threads() const _NOEXCEPT {return __table_.shuffle_threads();}
+    _LIBCPP_INLINE_VISIBILITY
+    void shuffle_threads(unsigned __n) _NOEXCEPT {__table_.shuffle_threads() = __n;}
+    // A one-thread shuffle takes O(size()) time and an O(size()) index of the
+    // nodes. Without memory for the index, or with shuffle_in_place(true), it
+    // merge-shuffles the node chain instead: O(size() log size()) time, and
+    // nothing allocated.
+    _LIBCPP_INLINE_VISIBILITY
+    bool shuffle_in_place() const _NOEXCEPT {return __table_.shuffle_in_place();}
+    _LIBCPP_INLINE_VISIBILITY
+    void shuffle_in_place(bool __on) _NOEXCEPT {__table_.shuffle_in_place() = __on;}
+
+    // The bucket_* settings below exist only when hash_bucket_features<_Value,
+    // _Hash> turns them on, so that other sets pay nothing for them; without
+    // it the getter reports the setting off and the setter does not compile.
+    //
+    // With bucket fingerprints on, each bucket keeps a byte summarizing the
+    // hashes in it, and most lookups of absent keys finish without reading a
+    // node. The bytes share the bucket array's allocation, so changing the
+    // setting reallocates it like rehash(bucket_count()), in O(size()) and
+    // invalidating iterators.
+    _LIBCPP_INLINE_VISIBILITY
+    bool bucket_fingerprints() const _NOEXCEPT {return __table_.bucket_fingerprints();}
+    _LIBCPP_INLINE_VISIBILITY
+    void bucket_fingerprints(bool __on) {__table_.bucket_fingerprints(__on);}
+
+    // Bucket arrays of at least __min_bytes bytes are mapped on 2 MiB pages
+    // where the system allows it, cutting the TLB misses of lookups and
+    // rehashes in very large sets; 0, the default, turns this off. Moves the
+    // current bucket array, invalidating iterators, if that changes where it
+    // should live.
+    _LIBCPP_INLINE_VISIBILITY
+    size_type bucket_huge_pages() const _NOEXCEPT {return __table_.bucket_huge_pages();}
+    _LIBCPP_INLINE_VISIBILITY
+    void bucket_huge_pages(size_type __min_bytes) {__table_.bucket_huge_pages(__min_bytes);}
+
+    // With power-of-two mixing on, bucket counts are powers of two and a
+    // hash picks its bucket by a multiply and shift (Fibonacci hashing)
+    // rather than a remainder, which also keeps identity-like hashes of
+    // strided integers or aligned pointers from sharing a few buckets.
+    // Changing it rehashes, invalidating iterators.
+    _LIBCPP_INLINE_VISIBILITY
+    bool bucket_pow2_mixing() const _NOEXCEPT {return __table_.bucket_pow2_mixing();}
+    _LIBCPP_INLINE_VISIBILITY
+    void bucket_pow2_mixing(bool __on) {__table_.bucket_pow2_mixing(__on);}
+    // END CODE
+
 #if _LIBCPP_DEBUG_LEVEL >= 2
 
     bool __dereferenceable(const const_iterator* __i) const
@@ -1157,8 +1617,8 @@ public:
 
 };
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
-unordered_multiset<_Value, _Hash, _Pred, _Alloc>::unordered_multiset(
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
+unordered_multiset<_Value, _Hash, _Pred, _Alloc, _Order>::unordered_multiset(
         size_type __n, const hasher& __hf, const key_equal& __eql)
     : __table_(__hf, __eql)
 {
@@ -1168,8 +1628,8 @@ unordered_multiset<_Value, _Hash, _Pred, _Alloc>::unordered_multiset(
     __table_.rehash(__n);
 }
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
-unordered_multiset<_Value, _Hash, _Pred, _Alloc>::unordered_multiset(
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
+unordered_multiset<_Value, _Hash, _Pred, _Alloc, _Order>::unordered_multiset(
         size_type __n, const hasher& __hf, const key_equal& __eql,
         const allocator_type& __a)
     : __table_(__hf, __eql, __a)
@@ -1180,9 +1640,9 @@ unordered_multiset<_Value, _Hash, _Pred, _Alloc>::unordered_multiset(
     __table_.rehash(__n);
 }
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
 template <class _InputIterator>
-unordered_multiset<_Value, _Hash, _Pred, _Alloc>::unordered_multiset(
+unordered_multiset<_Value, _Hash, _Pred, _Alloc, _Order>::unordered_multiset(
         _InputIterator __first, _InputIterator __last)
 {
 #if _LIBCPP_DEBUG_LEVEL >= 2
@@ -1191,9 +1651,9 @@ unordered_multiset<_Value, _Hash, _Pred, _Alloc>::unordered_multiset(
     insert(__first, __last);
 }
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
 template <class _InputIterator>
-unordered_multiset<_Value, _Hash, _Pred, _Alloc>::unordered_multiset(
+unordered_multiset<_Value, _Hash, _Pred, _Alloc, _Order>::unordered_multiset(
         _InputIterator __first, _InputIterator __last, size_type __n,
         const hasher& __hf, const key_equal& __eql)
     : __table_(__hf, __eql)
@@ -1205,9 +1665,9 @@ unordered_multiset<_Value, _Hash, _Pred, _Alloc>::unordered_multiset(
     insert(__first, __last);
 }
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
 template <class _InputIterator>
-unordered_multiset<_Value, _Hash, _Pred, _Alloc>::unordered_multiset(
+unordered_multiset<_Value, _Hash, _Pred, _Alloc, _Order>::unordered_multiset(
         _InputIterator __first, _InputIterator __last, size_type __n,
         const hasher& __hf, const key_equal& __eql, const allocator_type& __a)
     : __table_(__hf, __eql, __a)
@@ -1219,9 +1679,9 @@ unordered_multiset<_Value, _Hash, _Pred, _Alloc>::unordered_multiset(
     insert(__first, __last);
 }
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
 inline
-unordered_multiset<_Value, _Hash, _Pred, _Alloc>::unordered_multiset(
+unordered_multiset<_Value, _Hash, _Pred, _Alloc, _Order>::unordered_multiset(
         const allocator_type& __a)
     : __table_(__a)
 {
@@ -1230,8 +1690,8 @@ unordered_multiset<_Value, _Hash, _Pred, _Alloc>::unordered_multiset(
 #endif
 }
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
-unordered_multiset<_Value, _Hash, _Pred, _Alloc>::unordered_multiset(
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
+unordered_multiset<_Value, _Hash, _Pred, _Alloc, _Order>::unordered_multiset(
         const unordered_multiset& __u)
     : __table_(__u.__table_)
 {
@@ -1242,8 +1702,8 @@ unordered_multiset<_Value, _Hash, _Pred, _Alloc>::unordered_multiset(
     insert(__u.begin(), __u.end());
 }
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
-unordered_multiset<_Value, _Hash, _Pred, _Alloc>::unordered_multiset(
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
+unordered_multiset<_Value, _Hash, _Pred, _Alloc, _Order>::unordered_multiset(
         const unordered_multiset& __u, const allocator_type& __a)
     : __table_(__u.__table_, __a)
 {
@@ -1256,9 +1716,9 @@ unordered_multiset<_Value, _Hash, _Pred, _Alloc>::unordered_multiset(
 
 #ifndef _LIBCPP_HAS_NO_RVALUE_REFERENCES
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
 inline
-unordered_multiset<_Value, _Hash, _Pred, _Alloc>::unordered_multiset(
+unordered_multiset<_Value, _Hash, _Pred, _Alloc, _Order>::unordered_multiset(
         unordered_multiset&& __u)
     _NOEXCEPT_(is_nothrow_move_constructible<__table>::value)
     : __table_(_VSTD::move(__u.__table_))
@@ -1269,8 +1729,8 @@ unordered_multiset<_Value, _Hash, _Pred, _Alloc>::unordered_multiset(
 #endif
 }
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
-unordered_multiset<_Value, _Hash, _Pred, _Alloc>::unordered_multiset(
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
+unordered_multiset<_Value, _Hash, _Pred, _Alloc, _Order>::unordered_multiset(
         unordered_multiset&& __u, const allocator_type& __a)
     : __table_(_VSTD::move(__u.__table_), __a)
 {
@@ -1293,8 +1753,8 @@ unordered_multiset<_Value, _Hash, _Pred, _Alloc>::unordered_multiset(
 
 #ifndef _LIBCPP_HAS_NO_GENERALIZED_INITIALIZERS
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
-unordered_multiset<_Value, _Hash, _Pred, _Alloc>::unordered_multiset(
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
+unordered_multiset<_Value, _Hash, _Pred, _Alloc, _Order>::unordered_multiset(
         initializer_list<value_type> __il)
 {
 #if _LIBCPP_DEBUG_LEVEL >= 2
@@ -1303,8 +1763,8 @@ unordered_multiset<_Value, _Hash, _Pred, _Alloc>::unordered_multiset(
     insert(__il.begin(), __il.end());
 }
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
-unordered_multiset<_Value, _Hash, _Pred, _Alloc>::unordered_multiset(
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
+unordered_multiset<_Value, _Hash, _Pred, _Alloc, _Order>::unordered_multiset(
         initializer_list<value_type> __il, size_type __n, const hasher& __hf,
         const key_equal& __eql)
     : __table_(__hf, __eql)
@@ -1316,8 +1776,8 @@ unordered_multiset<_Value, _Hash, _Pred, _Alloc>::unordered_multiset(
     insert(__il.begin(), __il.end());
 }
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
-unordered_multiset<_Value, _Hash, _Pred, _Alloc>::unordered_multiset(
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
+unordered_multiset<_Value, _Hash, _Pred, _Alloc, _Order>::unordered_multiset(
         initializer_list<value_type> __il, size_type __n, const hasher& __hf,
         const key_equal& __eql, const allocator_type& __a)
     : __table_(__hf, __eql, __a)
@@ -1333,10 +1793,10 @@ unordered_multiset<_Value, _Hash, _Pred, _Alloc>::unordered_multiset(
 
 #ifndef _LIBCPP_HAS_NO_RVALUE_REFERENCES
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
 inline
-unordered_multiset<_Value, _Hash, _Pred, _Alloc>&
-unordered_multiset<_Value, _Hash, _Pred, _Alloc>::operator=(
+unordered_multiset<_Value, _Hash, _Pred, _Alloc, _Order>&
+unordered_multiset<_Value, _Hash, _Pred, _Alloc, _Order>::operator=(
         unordered_multiset&& __u)
     _NOEXCEPT_(is_nothrow_move_assignable<__table>::value)
 {
@@ -1348,10 +1808,10 @@ unordered_multiset<_Value, _Hash, _Pred, _Alloc>::operator=(
 
 #ifndef _LIBCPP_HAS_NO_GENERALIZED_INITIALIZERS
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
 inline
-unordered_multiset<_Value, _Hash, _Pred, _Alloc>&
-unordered_multiset<_Value, _Hash, _Pred, _Alloc>::operator=(
+unordered_multiset<_Value, _Hash, _Pred, _Alloc, _Order>&
+unordered_multiset<_Value, _Hash, _Pred, _Alloc, _Order>::operator=(
         initializer_list<value_type> __il)
 {
     __table_.__assign_multi(__il.begin(), __il.end());
@@ -1360,35 +1820,35 @@ unordered_multiset<_Value, _Hash, _Pred, _Alloc>::operator=(
 
 #endif  // _LIBCPP_HAS_NO_GENERALIZED_INITIALIZERS
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
 template <class _InputIterator>
 inline
 void
-unordered_multiset<_Value, _Hash, _Pred, _Alloc>::insert(_InputIterator __first,
+unordered_multiset<_Value, _Hash, _Pred, _Alloc, _Order>::insert(_InputIterator __first,
                                                          _InputIterator __last)
 {
     for (; __first != __last; ++__first)
         __table_.__insert_multi(*__first);
 }
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
 inline _LIBCPP_INLINE_VISIBILITY
 void
-swap(unordered_multiset<_Value, _Hash, _Pred, _Alloc>& __x,
-     unordered_multiset<_Value, _Hash, _Pred, _Alloc>& __y)
+swap(unordered_multiset<_Value, _Hash, _Pred, _Alloc, _Order>& __x,
+     unordered_multiset<_Value, _Hash, _Pred, _Alloc, _Order>& __y)
     _NOEXCEPT_(_NOEXCEPT_(__x.swap(__y)))
 {
     __x.swap(__y);
 }
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
 bool
-operator==(const unordered_multiset<_Value, _Hash, _Pred, _Alloc>& __x,
-           const unordered_multiset<_Value, _Hash, _Pred, _Alloc>& __y)
+operator==(const unordered_multiset<_Value, _Hash, _Pred, _Alloc, _Order>& __x,
+           const unordered_multiset<_Value, _Hash, _Pred, _Alloc, _Order>& __y)
 {
     if (__x.size() != __y.size())
         return false;
-    typedef typename unordered_multiset<_Value, _Hash, _Pred, _Alloc>::const_iterator
+    typedef typename unordered_multiset<_Value, _Hash, _Pred, _Alloc, _Order>::const_iterator
                                                                  const_iterator;
     typedef pair<const_iterator, const_iterator> _EqRng;
     for (const_iterator __i = __x.begin(), __ex = __x.end(); __i != __ex;)
@@ -1404,15 +1864,835 @@ operator==(const unordered_multiset<_Value, _Hash, _Pred, _Alloc>& __x,
     return true;
 }
 
-template <class _Value, class _Hash, class _Pred, class _Alloc>
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Order>
 inline _LIBCPP_INLINE_VISIBILITY
 bool
-operator!=(const unordered_multiset<_Value, _Hash, _Pred, _Alloc>& __x,
-           const unordered_multiset<_Value, _Hash, _Pred, _Alloc>& __y)
+operator!=(const unordered_multiset<_Value, _Hash, _Pred, _Alloc, _Order>& __x,
+           const unordered_multiset<_Value, _Hash, _Pred, _Alloc, _Order>& __y)
 {
     return !(__x == __y);
 }
 
+// START ADDED CODE
+#ifndef _LIBCPP_CXX03_LANG
+
+// Storage engines for engine_unordered_set. Each names its table template
+// as __table.
+//
+// node_hash_engine is libc++'s node-based __hash_table: engine_unordered_set
+// over it is unordered_set itself, extensions included.
+struct _LIBCPP_TEMPLATE_VIS node_hash_engine {};
+
+// flat_hash_engine is the open-addressing __flat_hash_table. Elements are
+// stored in place, so rehashing (including the growth an insert may
+// trigger) invalidates references and pointers to elements, not just
+// iterators.
+struct _LIBCPP_TEMPLATE_VIS flat_hash_engine
+{
+    template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        using __table = __flat_hash_table<_Tp, _Hash, _Equal, _Alloc>;
+};
+
+// dense_hash_engine is __dense_hash_table: elements in one contiguous
+// vector, chained through 32-bit indices. Iteration is a linear scan in
+// insertion order until the first erase. Elements move when the vector
+// grows, and erase moves the last element into the hole, so insertions
+// invalidate references and pointers as well as iterators, and erasure
+// invalidates those to the last element. Holds at most 2^32 - 2 elements.
+struct _LIBCPP_TEMPLATE_VIS dense_hash_engine
+{
+    template <class _Tp, class _Hash, class _Equal, class _Alloc>
+        using __table = __dense_hash_table<_Tp, _Hash, _Equal, _Alloc>;
+};
+
+// unordered_set over a storage engine other than node_hash_engine. The
+// interface is unordered_set's, less the per-bucket and randomized-iteration
+// extensions; what differs is _Engine's invalidation rules above.
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Engine>
+class _LIBCPP_TEMPLATE_VIS __engine_unordered_set
+{
+public:
+    // types
+    typedef _Value                                                     key_type;
+    typedef key_type                                                   value_type;
+    typedef _Hash                                                      hasher;
+    typedef _Pred                                                      key_equal;
+    typedef _Alloc                                                     allocator_type;
+    typedef value_type&                                                reference;
+    typedef const value_type&                                          const_reference;
+    static_assert((is_same<value_type, typename allocator_type::value_type>::value),
+                  "Invalid allocator::value_type");
+
+private:
+    typedef typename _Engine::template __table<value_type, hasher, key_equal, allocator_type> __table;
+
+    __table __table_;
+
+public:
+    typedef typename __table::pointer         pointer;
+    typedef typename __table::const_pointer   const_pointer;
+    typedef typename __table::size_type       size_type;
+    typedef typename __table::difference_type difference_type;
+
+    typedef typename __table::const_iterator iterator;
+    typedef typename __table::const_iterator const_iterator;
+
+    _LIBCPP_INLINE_VISIBILITY
+    __engine_unordered_set()
+        _NOEXCEPT_(is_nothrow_default_constructible<__table>::value) {}
+    explicit __engine_unordered_set(size_type __n, const hasher& __hf = hasher(),
+                                    const key_equal& __eql = key_equal())
+        : __table_(__hf, __eql) {__table_.reserve(__n);}
+    __engine_unordered_set(size_type __n, const hasher& __hf, const key_equal& __eql,
+                           const allocator_type& __a)
+        : __table_(__hf, __eql, __a) {__table_.reserve(__n);}
+    _LIBCPP_INLINE_VISIBILITY
+    __engine_unordered_set(size_type __n, const allocator_type& __a)
+        : __engine_unordered_set(__n, hasher(), key_equal(), __a) {}
+    _LIBCPP_INLINE_VISIBILITY
+    __engine_unordered_set(size_type __n, const hasher& __hf, const allocator_type& __a)
+        : __engine_unordered_set(__n, __hf, key_equal(), __a) {}
+    template <class _InputIterator>
+    __engine_unordered_set(_InputIterator __first, _InputIterator __last)
+        {insert(__first, __last);}
+    template <class _InputIterator>
+    __engine_unordered_set(_InputIterator __first, _InputIterator __last,
+                           size_type __n, const hasher& __hf = hasher(),
+                           const key_equal& __eql = key_equal())
+        : __engine_unordered_set(__n, __hf, __eql) {insert(__first, __last);}
+    template <class _InputIterator>
+    __engine_unordered_set(_InputIterator __first, _InputIterator __last,
+                           size_type __n, const hasher& __hf, const key_equal& __eql,
+                           const allocator_type& __a)
+        : __engine_unordered_set(__n, __hf, __eql, __a) {insert(__first, __last);}
+    _LIBCPP_INLINE_VISIBILITY
+    explicit __engine_unordered_set(const allocator_type& __a) : __table_(__a) {}
+    __engine_unordered_set(const __engine_unordered_set& __u) = default;
+    _LIBCPP_INLINE_VISIBILITY
+    __engine_unordered_set(const __engine_unordered_set& __u, const allocator_type& __a)
+        : __table_(__u.__table_, __a) {}
+    _LIBCPP_INLINE_VISIBILITY
+    __engine_unordered_set(__engine_unordered_set&& __u)
+        _NOEXCEPT_(is_nothrow_move_constructible<__table>::value)
+        : __table_(_VSTD::move(__u.__table_)) {}
+    _LIBCPP_INLINE_VISIBILITY
+    __engine_unordered_set(__engine_unordered_set&& __u, const allocator_type& __a)
+        : __table_(_VSTD::move(__u.__table_), __a) {}
+    __engine_unordered_set(initializer_list<value_type> __il)
+        {insert(__il.begin(), __il.end());}
+    __engine_unordered_set(initializer_list<value_type> __il, size_type __n,
+                           const hasher& __hf = hasher(),
+                           const key_equal& __eql = key_equal())
+        : __engine_unordered_set(__n, __hf, __eql) {insert(__il.begin(), __il.end());}
+    __engine_unordered_set(initializer_list<value_type> __il, size_type __n,
+                           const hasher& __hf, const key_equal& __eql,
+                           const allocator_type& __a)
+        : __engine_unordered_set(__n, __hf, __eql, __a) {insert(__il.begin(), __il.end());}
+
+    __engine_unordered_set& operator=(const __engine_unordered_set& __u) = default;
+    _LIBCPP_INLINE_VISIBILITY
+    __engine_unordered_set& operator=(__engine_unordered_set&& __u)
+        _NOEXCEPT_(is_nothrow_move_assignable<__table>::value)
+        {__table_ = _VSTD::move(__u.__table_); return *this;}
+    _LIBCPP_INLINE_VISIBILITY
+    __engine_unordered_set& operator=(initializer_list<value_type> __il)
+        {clear(); insert(__il.begin(), __il.end()); return *this;}
+
+    _LIBCPP_INLINE_VISIBILITY
+    allocator_type get_allocator() const _NOEXCEPT
+        {return __table_.__alloc();}
+
+    _LIBCPP_INLINE_VISIBILITY
+    bool      empty() const _NOEXCEPT {return __table_.size() == 0;}
+    _LIBCPP_INLINE_VISIBILITY
+    size_type size() const _NOEXCEPT  {return __table_.size();}
+    _LIBCPP_INLINE_VISIBILITY
+    size_type max_size() const _NOEXCEPT {return __table_.max_size();}
+
+    _LIBCPP_INLINE_VISIBILITY
+    iterator       begin() _NOEXCEPT        {return __table_.begin();}
+    _LIBCPP_INLINE_VISIBILITY
+    iterator       end() _NOEXCEPT          {return __table_.end();}
+    _LIBCPP_INLINE_VISIBILITY
+    const_iterator begin()  const _NOEXCEPT {return __table_.begin();}
+    _LIBCPP_INLINE_VISIBILITY
+    const_iterator end()    const _NOEXCEPT {return __table_.end();}
+    _LIBCPP_INLINE_VISIBILITY
+    const_iterator cbegin() const _NOEXCEPT {return __table_.begin();}
+    _LIBCPP_INLINE_VISIBILITY
+    const_iterator cend()   const _NOEXCEPT {return __table_.end();}
+
+    template <class... _Args>
+        _LIBCPP_INLINE_VISIBILITY
+        pair<iterator, bool> emplace(_Args&&... __args)
+            {return __table_.__emplace_unique(_VSTD::forward<_Args>(__args)...);}
+    template <class... _Args>
+        _LIBCPP_INLINE_VISIBILITY
+        iterator emplace_hint(const_iterator, _Args&&... __args)
+            {return __table_.__emplace_unique(_VSTD::forward<_Args>(__args)...).first;}
+
+    _LIBCPP_INLINE_VISIBILITY
+    pair<iterator, bool> insert(const value_type& __x)
+        {return __table_.__insert_unique(__x);}
+    _LIBCPP_INLINE_VISIBILITY
+    pair<iterator, bool> insert(value_type&& __x)
+        {return __table_.__insert_unique(_VSTD::move(__x));}
+    _LIBCPP_INLINE_VISIBILITY
+    iterator insert(const_iterator, const value_type& __x)
+        {return insert(__x).first;}
+    _LIBCPP_INLINE_VISIBILITY
+    iterator insert(const_iterator, value_type&& __x)
+        {return insert(_VSTD::move(__x)).first;}
+    template <class _InputIterator>
+        _LIBCPP_INLINE_VISIBILITY
+        void insert(_InputIterator __first, _InputIterator __last)
+        {
+            for (; __first != __last; ++__first)
+                __table_.__insert_unique(*__first);
+        }
+    _LIBCPP_INLINE_VISIBILITY
+    void insert(initializer_list<value_type> __il)
+        {insert(__il.begin(), __il.end());}
+
+    _LIBCPP_INLINE_VISIBILITY
+    iterator erase(const_iterator __p) {return __table_.erase(__p);}
+    _LIBCPP_INLINE_VISIBILITY
+    size_type erase(const key_type& __k) {return __table_.__erase_unique(__k);}
+    _LIBCPP_INLINE_VISIBILITY
+    iterator erase(const_iterator __first, const_iterator __last)
+        {return __table_.erase(__first, __last);}
+    _LIBCPP_INLINE_VISIBILITY
+    void clear() _NOEXCEPT {__table_.clear();}
+
+    _LIBCPP_INLINE_VISIBILITY
+    void swap(__engine_unordered_set& __u)
+        _NOEXCEPT_(__is_nothrow_swappable<__table>::value)
+        {__table_.swap(__u.__table_);}
+
+    _LIBCPP_INLINE_VISIBILITY
+    hasher hash_function() const {return __table_.hash_function();}
+    _LIBCPP_INLINE_VISIBILITY
+    key_equal key_eq() const {return __table_.key_eq();}
+
+    _LIBCPP_INLINE_VISIBILITY
+    iterator       find(const key_type& __k)       {return __table_.find(__k);}
+    _LIBCPP_INLINE_VISIBILITY
+    const_iterator find(const key_type& __k) const {return __table_.find(__k);}
+    _LIBCPP_INLINE_VISIBILITY
+    size_type count(const key_type& __k) const {return __table_.__count_unique(__k);}
+    _LIBCPP_INLINE_VISIBILITY
+    pair<iterator, iterator> equal_range(const key_type& __k)
+    {
+        iterator __i = find(__k);
+        return pair<iterator, iterator>(__i, __i == end() ? __i : _VSTD::next(__i));
+    }
+    _LIBCPP_INLINE_VISIBILITY
+    pair<const_iterator, const_iterator> equal_range(const key_type& __k) const
+    {
+        const_iterator __i = find(__k);
+        return pair<const_iterator, const_iterator>(__i, __i == end() ? __i : _VSTD::next(__i));
+    }
+
+    _LIBCPP_INLINE_VISIBILITY
+    size_type bucket_count() const _NOEXCEPT {return __table_.bucket_count();}
+    _LIBCPP_INLINE_VISIBILITY
+    size_type max_bucket_count() const _NOEXCEPT {return __table_.max_size();}
+
+    _LIBCPP_INLINE_VISIBILITY
+    float load_factor() const _NOEXCEPT {return __table_.load_factor();}
+    _LIBCPP_INLINE_VISIBILITY
+    float max_load_factor() const _NOEXCEPT {return __table_.max_load_factor();}
+    _LIBCPP_INLINE_VISIBILITY
+    void max_load_factor(float __mlf) {__table_.max_load_factor(__mlf);}
+    _LIBCPP_INLINE_VISIBILITY
+    void rehash(size_type __n) {__table_.rehash(__n);}
+    _LIBCPP_INLINE_VISIBILITY
+    void reserve(size_type __n) {__table_.reserve(__n);}
+};
+
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Engine>
+inline _LIBCPP_INLINE_VISIBILITY
+void
+swap(__engine_unordered_set<_Value, _Hash, _Pred, _Alloc, _Engine>& __x,
+     __engine_unordered_set<_Value, _Hash, _Pred, _Alloc, _Engine>& __y)
+    _NOEXCEPT_(_NOEXCEPT_(__x.swap(__y)))
+{
+    __x.swap(__y);
+}
+
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Engine>
+bool
+operator==(const __engine_unordered_set<_Value, _Hash, _Pred, _Alloc, _Engine>& __x,
+           const __engine_unordered_set<_Value, _Hash, _Pred, _Alloc, _Engine>& __y)
+{
+    if (__x.size() != __y.size())
+        return false;
+    typedef typename __engine_unordered_set<_Value, _Hash, _Pred, _Alloc, _Engine>::const_iterator
+                                                                          const_iterator;
+    for (const_iterator __i = __x.begin(), __ex = __x.end(), __ey = __y.end();
+            __i != __ex; ++__i)
+    {
+        const_iterator __j = __y.find(*__i);
+        if (__j == __ey || !(*__i == *__j))
+            return false;
+    }
+    return true;
+}
+
+template <class _Value, class _Hash, class _Pred, class _Alloc, class _Engine>
+inline _LIBCPP_INLINE_VISIBILITY
+bool
+operator!=(const __engine_unordered_set<_Value, _Hash, _Pred, _Alloc, _Engine>& __x,
+           const __engine_unordered_set<_Value, _Hash, _Pred, _Alloc, _Engine>& __y)
+{
+    return !(__x == __y);
+}
+
+template <class _Value, class _Hash = hash<_Value>, class _Pred = equal_to<_Value>,
+          class _Alloc = allocator<_Value> >
+using flat_unordered_set = __engine_unordered_set<_Value, _Hash, _Pred, _Alloc, flat_hash_engine>;
+
+template <class _Value, class _Hash = hash<_Value>, class _Pred = equal_to<_Value>,
+          class _Alloc = allocator<_Value> >
+using dense_unordered_set = __engine_unordered_set<_Value, _Hash, _Pred, _Alloc, dense_hash_engine>;
+
+template <class _Engine, class _Value, class _Hash, class _Pred, class _Alloc>
+struct __engine_unordered_set_select
+{
+    typedef __engine_unordered_set<_Value, _Hash, _Pred, _Alloc, _Engine> type;
+};
+
+template <class _Value, class _Hash, class _Pred, class _Alloc>
+struct __engine_unordered_set_select<node_hash_engine, _Value, _Hash, _Pred, _Alloc>
+{
+    typedef unordered_set<_Value, _Hash, _Pred, _Alloc> type;
+};
+
+// The set type for a storage engine chosen by a template parameter.
+template <class _Engine, class _Value, class _Hash = hash<_Value>,
+          class _Pred = equal_to<_Value>, class _Alloc = allocator<_Value> >
+using engine_unordered_set =
+    typename __engine_unordered_set_select<_Engine, _Value, _Hash, _Pred, _Alloc>::type;
+
+#endif  // _LIBCPP_CXX03_LANG
+// END CODE
+
+// START ADDED CODE
+#ifndef _LIBCPP_CXX03_LANG
+
+template <class _Tp, class _TableIter>
+class _LIBCPP_TEMPLATE_VIS __small_set_const_iterator
+{
+    // Inline mode walks __p_; hashed mode has __p_ == nullptr and walks __i_.
+    const _Tp* __p_;
+    _TableIter __i_;
+
+public:
+    typedef forward_iterator_tag iterator_category;
+    typedef _Tp                  value_type;
+    typedef ptrdiff_t            difference_type;
+    typedef const value_type&    reference;
+    typedef const value_type*    pointer;
+
+    _LIBCPP_INLINE_VISIBILITY
+    __small_set_const_iterator() _NOEXCEPT : __p_(nullptr) {}
+
+    _LIBCPP_INLINE_VISIBILITY
+    reference operator*() const {return __p_ != nullptr ? *__p_ : *__i_;}
+    _LIBCPP_INLINE_VISIBILITY
+    pointer operator->() const {return _VSTD::addressof(**this);}
+
+    _LIBCPP_INLINE_VISIBILITY
+    __small_set_const_iterator& operator++()
+    {
+        if (__p_ != nullptr)
+            ++__p_;
+        else
+            ++__i_;
+        return *this;
+    }
+    _LIBCPP_INLINE_VISIBILITY
+    __small_set_const_iterator operator++(int)
+    {
+        __small_set_const_iterator __t(*this);
+        ++(*this);
+        return __t;
+    }
+
+    friend _LIBCPP_INLINE_VISIBILITY
+    bool operator==(const __small_set_const_iterator& __x, const __small_set_const_iterator& __y)
+    {
+        return __x.__p_ == __y.__p_ && (__x.__p_ != nullptr || __x.__i_ == __y.__i_);
+    }
+    friend _LIBCPP_INLINE_VISIBILITY
+    bool operator!=(const __small_set_const_iterator& __x, const __small_set_const_iterator& __y)
+    {return !(__x == __y);}
+
+private:
+    _LIBCPP_INLINE_VISIBILITY
+    explicit __small_set_const_iterator(const _Tp* __p) _NOEXCEPT : __p_(__p) {}
+    _LIBCPP_INLINE_VISIBILITY
+    explicit __small_set_const_iterator(_TableIter __i) _NOEXCEPT : __p_(nullptr), __i_(__i) {}
+
+    template <class, size_t, class, class, class> friend class _LIBCPP_TEMPLATE_VIS small_unordered_set;
+};
+
+// unordered_set that keeps up to _Np elements inline, next to their hashes,
+// and finds them by a linear scan that compares hashes before keys. Nothing
+// is allocated until the _Np+1st element arrives; then every element moves
+// into an ordinary __hash_table and the set behaves like unordered_set until
+// clear() returns it to inline mode. Erasing from inline mode fills the hole
+// with the last element. bucket_count() is 0 in inline mode.
+template <class _Value, size_t _Np = 8, class _Hash = hash<_Value>,
+          class _Pred = equal_to<_Value>, class _Alloc = allocator<_Value> >
+class _LIBCPP_TEMPLATE_VIS small_unordered_set
+{
+public:
+    // types
+    typedef _Value                                                     key_type;
+    typedef key_type                                                   value_type;
+    typedef _Hash                                                      hasher;
+    typedef _Pred                                                      key_equal;
+    typedef _Alloc                                                     allocator_type;
+    typedef value_type&                                                reference;
+    typedef const value_type&                                          const_reference;
+    static_assert((is_same<value_type, typename allocator_type::value_type>::value),
+                  "Invalid allocator::value_type");
+    static_assert(_Np > 0, "small_unordered_set needs room for at least one element");
+
+private:
+    typedef __hash_table<value_type, hasher, key_equal, allocator_type> __table;
+    typedef allocator_traits<allocator_type>                           __alloc_traits;
+    typedef typename aligned_storage<sizeof(value_type),
+                                     alignment_of<value_type>::value>::type __slot;
+
+    // The table is always there, for the hasher, key_equal and allocator,
+    // but holds elements only once __large_ is set.
+    __table   __table_;
+    bool      __large_;
+    size_t    __small_size_;
+    size_t    __hashes_[_Np];
+    __slot    __slots_[_Np];
+
+public:
+    typedef typename __table::pointer         pointer;
+    typedef typename __table::const_pointer   const_pointer;
+    typedef typename __table::size_type       size_type;
+    typedef typename __table::difference_type difference_type;
+
+    typedef __small_set_const_iterator<value_type, typename __table::const_iterator> iterator;
+    typedef iterator                                                                 const_iterator;
+
+    _LIBCPP_INLINE_VISIBILITY
+    small_unordered_set()
+        _NOEXCEPT_(is_nothrow_default_constructible<__table>::value)
+        : __large_(false), __small_size_(0) {}
+    explicit small_unordered_set(size_type __n, const hasher& __hf = hasher(),
+                                 const key_equal& __eql = key_equal())
+        : __table_(__hf, __eql), __large_(false), __small_size_(0) {reserve(__n);}
+    small_unordered_set(size_type __n, const hasher& __hf, const key_equal& __eql,
+                        const allocator_type& __a)
+        : __table_(__hf, __eql, __a), __large_(false), __small_size_(0) {reserve(__n);}
+    template <class _InputIterator>
+    small_unordered_set(_InputIterator __first, _InputIterator __last)
+        : __large_(false), __small_size_(0) {insert(__first, __last);}
+    template <class _InputIterator>
+    small_unordered_set(_InputIterator __first, _InputIterator __last,
+                        size_type __n, const hasher& __hf = hasher(),
+                        const key_equal& __eql = key_equal())
+        : small_unordered_set(__n, __hf, __eql) {insert(__first, __last);}
+    _LIBCPP_INLINE_VISIBILITY
+    explicit small_unordered_set(const allocator_type& __a)
+        : __table_(__a), __large_(false), __small_size_(0) {}
+    // Copying a table copies its hasher, key_equal and allocator but no
+    // elements; they follow in __u's mode, inline ones with their hashes.
+    small_unordered_set(const small_unordered_set& __u)
+        : __table_(__u.__table_), __large_(__u.__large_), __small_size_(0)
+    {
+        if (__large_)
+        {
+            __table_.rehash(__u.__table_.bucket_count());
+            for (typename __table::const_iterator __i = __u.__table_.begin();
+                 __i != __u.__table_.end(); ++__i)
+                __table_.__insert_unique(*__i);
+        }
+        else
+            __copy_small(__u);
+    }
+    small_unordered_set(small_unordered_set&& __u)
+        _NOEXCEPT_(is_nothrow_move_constructible<__table>::value &&
+                   is_nothrow_move_constructible<value_type>::value)
+        : __table_(_VSTD::move(__u.__table_)), __large_(__u.__large_), __small_size_(0)
+        {__steal_small(__u);}
+    small_unordered_set(initializer_list<value_type> __il)
+        : __large_(false), __small_size_(0) {insert(__il.begin(), __il.end());}
+    ~small_unordered_set() {__destroy_small();}
+
+    small_unordered_set& operator=(const small_unordered_set& __u)
+    {
+        if (this != &__u)
+        {
+            // Assigning the table copies its elements, which __u has only
+            // in hashed mode; this set then takes over that mode as well
+            // rather than keep copies it cannot see.
+            clear();
+            __large_ = __u.__large_;
+            __table_ = __u.__table_;
+            if (!__large_)
+                __copy_small(__u);
+        }
+        return *this;
+    }
+    small_unordered_set& operator=(small_unordered_set&& __u)
+        _NOEXCEPT_(is_nothrow_move_assignable<__table>::value &&
+                   is_nothrow_move_constructible<value_type>::value)
+    {
+        if (this != &__u)
+        {
+            __destroy_small();
+            __table_ = _VSTD::move(__u.__table_);
+            __large_ = __u.__large_;
+            __steal_small(__u);
+        }
+        return *this;
+    }
+    _LIBCPP_INLINE_VISIBILITY
+    small_unordered_set& operator=(initializer_list<value_type> __il)
+        {clear(); insert(__il.begin(), __il.end()); return *this;}
+
+    _LIBCPP_INLINE_VISIBILITY
+    allocator_type get_allocator() const _NOEXCEPT
+        {return allocator_type(__table_.__node_alloc());}
+
+    _LIBCPP_INLINE_VISIBILITY
+    bool      empty() const _NOEXCEPT {return size() == 0;}
+    _LIBCPP_INLINE_VISIBILITY
+    size_type size() const _NOEXCEPT  {return __large_ ? __table_.size() : __small_size_;}
+    _LIBCPP_INLINE_VISIBILITY
+    size_type max_size() const _NOEXCEPT {return __table_.max_size();}
+
+    _LIBCPP_INLINE_VISIBILITY
+    const_iterator begin() const _NOEXCEPT
+        {return __large_ ? const_iterator(__table_.begin()) : const_iterator(__small_at(0));}
+    _LIBCPP_INLINE_VISIBILITY
+    const_iterator end() const _NOEXCEPT
+        {return __large_ ? const_iterator(__table_.end()) : const_iterator(__small_at(__small_size_));}
+    _LIBCPP_INLINE_VISIBILITY
+    const_iterator cbegin() const _NOEXCEPT {return begin();}
+    _LIBCPP_INLINE_VISIBILITY
+    const_iterator cend() const _NOEXCEPT {return end();}
+
+    template <class... _Args>
+        _LIBCPP_INLINE_VISIBILITY
+        pair<iterator, bool> emplace(_Args&&... __args)
+            {return __insert(value_type(_VSTD::forward<_Args>(__args)...));}
+    template <class... _Args>
+        _LIBCPP_INLINE_VISIBILITY
+        iterator emplace_hint(const_iterator, _Args&&... __args)
+            {return emplace(_VSTD::forward<_Args>(__args)...).first;}
+
+    _LIBCPP_INLINE_VISIBILITY
+    pair<iterator, bool> insert(const value_type& __x) {return __insert(__x);}
+    _LIBCPP_INLINE_VISIBILITY
+    pair<iterator, bool> insert(value_type&& __x) {return __insert(_VSTD::move(__x));}
+    _LIBCPP_INLINE_VISIBILITY
+    iterator insert(const_iterator, const value_type& __x) {return insert(__x).first;}
+    _LIBCPP_INLINE_VISIBILITY
+    iterator insert(const_iterator, value_type&& __x) {return insert(_VSTD::move(__x)).first;}
+    template <class _InputIterator>
+        _LIBCPP_INLINE_VISIBILITY
+        void insert(_InputIterator __first, _InputIterator __last)
+        {
+            for (; __first != __last; ++__first)
+                __insert(*__first);
+        }
+    _LIBCPP_INLINE_VISIBILITY
+    void insert(initializer_list<value_type> __il) {insert(__il.begin(), __il.end());}
+
+    iterator erase(const_iterator __p)
+    {
+        if (__large_)
+            return iterator(__table_.erase(__p.__i_));
+        size_t __i = static_cast<size_t>(__p.__p_ - __small_at(0));
+        __erase_small(__i);
+        return iterator(__small_at(__i));
+    }
+    size_type erase(const key_type& __k)
+    {
+        if (__large_)
+            return __table_.__erase_unique(__k);
+        size_t __i = __find_small(__k, __table_.hash_function()(__k));
+        if (__i == __small_size_)
+            return 0;
+        __erase_small(__i);
+        return 1;
+    }
+    iterator erase(const_iterator __first, const_iterator __last)
+    {
+        if (__large_)
+            return iterator(__table_.erase(__first.__i_, __last.__i_));
+        // Erasing from the back keeps the backfill from pulling in elements
+        // of the range itself.
+        size_t __b = static_cast<size_t>(__first.__p_ - __small_at(0));
+        for (size_t __e = static_cast<size_t>(__last.__p_ - __small_at(0)); __e != __b; )
+            __erase_small(--__e);
+        return iterator(__small_at(__b));
+    }
+    // Destroys every element and returns to inline mode, giving back the
+    // table's buckets.
+    _LIBCPP_INLINE_VISIBILITY
+    void clear() _NOEXCEPT
+    {
+        __destroy_small();
+        if (__large_)
+        {
+            __table_.clear();
+            __table_.rehash(0);
+            __large_ = false;
+        }
+    }
+
+    void swap(small_unordered_set& __u)
+        _NOEXCEPT_(is_nothrow_move_constructible<small_unordered_set>::value &&
+                   is_nothrow_move_assignable<small_unordered_set>::value)
+    {
+        small_unordered_set __t(_VSTD::move(__u));
+        __u = _VSTD::move(*this);
+        *this = _VSTD::move(__t);
+    }
+
+    _LIBCPP_INLINE_VISIBILITY
+    hasher hash_function() const {return __table_.hash_function();}
+    _LIBCPP_INLINE_VISIBILITY
+    key_equal key_eq() const {return __table_.key_eq();}
+
+    const_iterator find(const key_type& __k) const
+    {
+        if (__large_)
+            return const_iterator(__table_.find(__k));
+        return const_iterator(__small_at(__find_small(__k, __table_.hash_function()(__k))));
+    }
+    _LIBCPP_INLINE_VISIBILITY
+    size_type count(const key_type& __k) const {return find(__k) != end();}
+    _LIBCPP_INLINE_VISIBILITY
+    pair<const_iterator, const_iterator> equal_range(const key_type& __k) const
+    {
+        const_iterator __i = find(__k);
+        return pair<const_iterator, const_iterator>(__i, __i == end() ? __i : _VSTD::next(__i));
+    }
+
+    _LIBCPP_INLINE_VISIBILITY
+    size_type bucket_count() const _NOEXCEPT {return __large_ ? __table_.bucket_count() : 0;}
+    _LIBCPP_INLINE_VISIBILITY
+    size_type max_bucket_count() const _NOEXCEPT {return __table_.max_bucket_count();}
+    _LIBCPP_INLINE_VISIBILITY
+    float load_factor() const _NOEXCEPT {return __large_ ? __table_.load_factor() : 0.f;}
+    _LIBCPP_INLINE_VISIBILITY
+    float max_load_factor() const _NOEXCEPT {return __table_.max_load_factor();}
+    _LIBCPP_INLINE_VISIBILITY
+    void max_load_factor(float __mlf) {__table_.max_load_factor(__mlf);}
+    // Asking for room beyond _Np switches to hashed mode early.
+    void rehash(size_type __n)
+    {
+        if (!__large_ && __n > _Np)
+            __grow();
+        if (__large_)
+            __table_.rehash(__n);
+    }
+    void reserve(size_type __n)
+    {
+        if (!__large_ && __n > _Np)
+            __grow();
+        if (__large_)
+            __table_.reserve(__n);
+    }
+
+private:
+    _LIBCPP_INLINE_VISIBILITY
+    value_type* __small_at(size_t __i) _NOEXCEPT
+        {return reinterpret_cast<value_type*>(_VSTD::addressof(__slots_[0])) + __i;}
+    _LIBCPP_INLINE_VISIBILITY
+    const value_type* __small_at(size_t __i) const _NOEXCEPT
+        {return reinterpret_cast<const value_type*>(_VSTD::addressof(__slots_[0])) + __i;}
+
+    // Index of __k in the inline array, or __small_size_.
+    _LIBCPP_INLINE_VISIBILITY
+    size_t __find_small(const key_type& __k, size_t __h) const
+    {
+        size_t __i = 0;
+        for (; __i < __small_size_; ++__i)
+            if (__hashes_[__i] == __h && __table_.key_eq()(*__small_at(__i), __k))
+                break;
+        return __i;
+    }
+
+    template <class _Vp>
+    pair<iterator, bool> __insert(_Vp&& __v)
+    {
+        if (!__large_)
+        {
+            size_t __h = __table_.hash_function()(__v);
+            size_t __i = __find_small(__v, __h);
+            if (__i != __small_size_)
+                return pair<iterator, bool>(iterator(__small_at(__i)), false);
+            if (__small_size_ < _Np)
+            {
+                allocator_type __a(__table_.__node_alloc());
+                __alloc_traits::construct(__a, __small_at(__i), _VSTD::forward<_Vp>(__v));
+                __hashes_[__i] = __h;
+                ++__small_size_;
+                return pair<iterator, bool>(iterator(__small_at(__i)), true);
+            }
+            __grow();
+        }
+        pair<typename __table::iterator, bool> __r =
+                __table_.__insert_unique(_VSTD::forward<_Vp>(__v));
+        return pair<iterator, bool>(iterator(__r.first), __r.second);
+    }
+
+    _LIBCPP_INLINE_VISIBILITY
+    void __erase_small(size_t __i)
+    {
+        allocator_type __a(__table_.__node_alloc());
+        size_t __last = --__small_size_;
+        if (__i != __last)
+        {
+            *__small_at(__i) = _VSTD::move(*__small_at(__last));
+            __hashes_[__i] = __hashes_[__last];
+        }
+        __alloc_traits::destroy(__a, __small_at(__last));
+    }
+
+    // Moves the inline elements into the table. If that throws, the elements
+    // already moved are put back and the set stays in inline mode.
+    void __grow()
+    {
+        __table_.reserve(_Np + 1);
+        size_t __i = 0;
+#ifndef _LIBCPP_NO_EXCEPTIONS
+        try
+        {
+#endif  // _LIBCPP_NO_EXCEPTIONS
+            for (; __i < __small_size_; ++__i)
+                __table_.__insert_unique(_VSTD::move_if_noexcept(*__small_at(__i)));
+#ifndef _LIBCPP_NO_EXCEPTIONS
+        }
+        catch (...)
+        {
+            // Only elements that were moved rather than copied need to come
+            // back; which slot each lands in does not matter.
+            if (is_nothrow_move_constructible<value_type>::value ||
+                !is_copy_constructible<value_type>::value)
+            {
+                allocator_type __a(__table_.__node_alloc());
+                size_t __j = 0;
+                for (typename __table::const_iterator __t = __table_.begin();
+                     __t != __table_.end(); ++__t, ++__j)
+                {
+                    __alloc_traits::destroy(__a, __small_at(__j));
+                    __alloc_traits::construct(__a, __small_at(__j),
+                                              _VSTD::move(const_cast<value_type&>(*__t)));
+                    __hashes_[__j] = __table_.hash_function()(*__small_at(__j));
+                }
+            }
+            __table_.clear();
+            throw;
+        }
+#endif  // _LIBCPP_NO_EXCEPTIONS
+        __destroy_small();
+        __large_ = true;
+    }
+
+    _LIBCPP_INLINE_VISIBILITY
+    void __destroy_small() _NOEXCEPT
+    {
+        allocator_type __a(__table_.__node_alloc());
+        for (size_t __i = 0; __i < __small_size_; ++__i)
+            __alloc_traits::destroy(__a, __small_at(__i));
+        __small_size_ = 0;
+    }
+
+    // Copies __u's inline elements into *this, which holds none, reusing
+    // their hashes. If a copy throws, the ones already made are destroyed.
+    void __copy_small(const small_unordered_set& __u)
+    {
+        allocator_type __a(__table_.__node_alloc());
+#ifndef _LIBCPP_NO_EXCEPTIONS
+        try
+        {
+#endif  // _LIBCPP_NO_EXCEPTIONS
+            for (size_t __i = 0; __i < __u.__small_size_; ++__i)
+            {
+                __alloc_traits::construct(__a, __small_at(__i), *__u.__small_at(__i));
+                __hashes_[__i] = __u.__hashes_[__i];
+                ++__small_size_;
+            }
+#ifndef _LIBCPP_NO_EXCEPTIONS
+        }
+        catch (...)
+        {
+            __destroy_small();
+            throw;
+        }
+#endif  // _LIBCPP_NO_EXCEPTIONS
+    }
+
+    // Moves __u's inline elements into *this, which holds none.
+    void __steal_small(small_unordered_set& __u)
+    {
+        allocator_type __a(__table_.__node_alloc());
+        for (size_t __i = 0; __i < __u.__small_size_; ++__i)
+        {
+            __alloc_traits::construct(__a, __small_at(__i), _VSTD::move(*__u.__small_at(__i)));
+            __hashes_[__i] = __u.__hashes_[__i];
+            ++__small_size_;
+        }
+        __u.__destroy_small();
+        __u.__large_ = false;
+    }
+};
+
+template <class _Value, size_t _Np, class _Hash, class _Pred, class _Alloc>
+inline _LIBCPP_INLINE_VISIBILITY
+void
+swap(small_unordered_set<_Value, _Np, _Hash, _Pred, _Alloc>& __x,
+     small_unordered_set<_Value, _Np, _Hash, _Pred, _Alloc>& __y)
+    _NOEXCEPT_(_NOEXCEPT_(__x.swap(__y)))
+{
+    __x.swap(__y);
+}
+
+template <class _Value, size_t _Np, class _Hash, class _Pred, class _Alloc>
+bool
+operator==(const small_unordered_set<_Value, _Np, _Hash, _Pred, _Alloc>& __x,
+           const small_unordered_set<_Value, _Np, _Hash, _Pred, _Alloc>& __y)
+{
+    if (__x.size() != __y.size())
+        return false;
+    typedef typename small_unordered_set<_Value, _Np, _Hash, _Pred, _Alloc>::const_iterator
+                                                                 const_iterator;
+    for (const_iterator __i = __x.begin(), __ex = __x.end(), __ey = __y.end();
+            __i != __ex; ++__i)
+    {
+        const_iterator __j = __y.find(*__i);
+        if (__j == __ey || !(*__i == *__j))
+            return false;
+    }
+    return true;
+}
+
+template <class _Value, size_t _Np, class _Hash, class _Pred, class _Alloc>
+inline _LIBCPP_INLINE_VISIBILITY
+bool
+operator!=(const small_unordered_set<_Value, _Np, _Hash, _Pred, _Alloc>& __x,
+           const small_unordered_set<_Value, _Np, _Hash, _Pred, _Alloc>& __y)
+{
+    return !(__x == __y);
+}
+
+#endif  // _LIBCPP_CXX03_LANG
+// END CODE
+
 _LIBCPP_END_NAMESPACE_STD
 
 #endif  // _LIBCPP_UNORDERED_SET